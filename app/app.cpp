@@ -28,7 +28,27 @@
 #include <iomanip>
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
 #include "coalescedhashing.h"
+#include "bucketizedcoalescedhashing.h"
+#include "compressedcoalescedhashing.h"
+#include "coalescedfilter.h"
+#include "durablecoalescedhashing.h"
+#include "sharedcoalescedhashing.h"
+#include "setoperations.h"
+#include "coalescedstringhashing.h"
+#include "exceptions.h"
+#include "perfcounters.h"
+#include "workload.h"
+#include "results.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <unistd.h>
+#include <sys/wait.h>
+#define APP_SHARED_MEMORY
+#endif
 
 using std::cin;
 using std::cout;
@@ -39,62 +59,1103 @@ using std::ofstream;
 #define TABLE_SIZE 13093
 #define ADDRESS_FACTOR 0.86
 
+/*--- Number of slots of the tables of the set operations. ---*/
+#define SET_TABLE_SIZE 1000003
+
 /*--- Function to round of a number to the given decimal places. ---*/
 double round_func( double number, int places ) {
 
-	double multiplier = pow( 10.0, places );
-	double roundValue = floor( number * multiplier + 0.5 );
-	roundValue = roundValue / multiplier;
-	return roundValue;
+	double multiplier = pow( 10.0, places );
+	double roundValue = floor( number * multiplier + 0.5 );
+	roundValue = roundValue / multiplier;
+	return roundValue;
+}
+
+/*--- Returns the packing factor that follows the given one, 1.0 after the last one. ---*/
+double nextPackingFactor( double packingFactor ) {
+
+	if( packingFactor == 0.8 )
+		return 0.9;
+
+	else if( packingFactor == 0.9 )
+		return 0.95;
+
+	else if( packingFactor == 0.95 )
+		return 0.99;
+
+	else if( packingFactor == 0.99 )
+		return 1.0;
+
+	return packingFactor + 0.2;
+}
+
+/*--- Creates the coalesced hashing table for the given algorithm: EISCH, LISCH, EICH or LICH. ---*/
+coalesced_hashing< int > createTable( int algorithm ) {
+
+	/*--- Even algorithms use early insertion. ---*/
+	bool early = ( algorithm % 2 ) == 0;
+
+	/*--- The last two algorithms use a cellar. ---*/
+	if( algorithm < 2 )
+		return coalesced_hashing< int >( TABLE_SIZE, early );
+
+	return coalesced_hashing< int >( TABLE_SIZE, early, ADDRESS_FACTOR );
+}
+
+/*--- Function to insert the integers into the coalesced hashing table, returns the elapsed seconds. ---*/
+template < class Table >
+double insert( Table & table, const vector< int > & list, int elements ) {
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+
+	/*--- For the number of elements. ---*/
+	for( int i = 0; i < elements; i++ ) {
+
+		/*--- Insert element. ---*/
+		table.insert( list[ i ] );
+	}
+
+	return std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+}
+
+/* Fills the empty table over the given number of passes and returns the
+ * seconds of the fastest.  The passes before the last fill copies of the
+ * empty table, so the table itself is filled once.
+*/
+template < class Table >
+double insert( Table & table, const vector< int > & list, int elements, int passes ) {
+
+	double fastest = 0.0;
+	for( int pass = 1; pass < passes; pass++ ) {
+
+		Table copy( table );
+		double seconds = insert( copy, list, elements );
+		if( ( pass == 1 ) || ( seconds < fastest ) )
+			fastest = seconds;
+	}
+
+	double seconds = insert( table, list, elements );
+	return ( ( passes > 1 ) && ( fastest < seconds ) ) ? fastest : seconds;
+}
+
+/*--- Returns the number of probes to find the key, zero when it is not stored. ---*/
+template < class Table >
+size_t probes( const Table & table, int key ) {
+
+	const_ref< int > element = table.find( key );
+	return element.isNULL( ) ? 0 : element.getProbes( );
+}
+
+/*--- Returns the number of probes to find the key in a compressed table, zero when it is not stored. ---*/
+size_t probes( const compressed_coalesced_hashing< int > & table, int key ) {
+
+	return table.search( key ).probes;
+}
+
+/* Save the results to file and record a measurement of the variant,
+ * the lookups are timed over the given number of passes.
+*/
+template < class Table >
+void saveResults( const Table & table, const vector< int > & list, ofstream & outFile, const char * variant,
+	double packingFactor, double insertSeconds, int repeats, vector< Measurement > & measurements ) {
+
+	/*--- Stores the combine probes for all the items searched for. ---*/
+	double totalProbes = 0;
+
+	/*--- Try to find all the items. ---*/
+	for( int i = 0; i < ( int )table.elements( ); i++ ) {
+
+		/*--- Get the number of probes. ---*/
+		totalProbes = totalProbes + probes( table, list[ i ] );
+	}
+
+	/*--- Print out the mean number of probes. ---*/
+	outFile << ( double )( totalProbes / ( double )table.elements( ) );
+	outFile << "\t\t";
+
+	/*--- Time the lookups, the checksum keeps them from being optimised away. ---*/
+	double sum = 0, squares = 0, fastest = 0;
+	long long checksum = 0;
+	for( int r = 0; r < repeats; r++ ) {
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+		for( int i = 0; i < ( int )table.elements( ); i++ )
+			checksum += table.contains( list[ i ] );
+
+		double ns = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / table.elements( );
+		sum += ns;
+		squares += ns * ns;
+		if( ( r == 0 ) || ( ns < fastest ) )
+			fastest = ns;
+	}
+
+	if( checksum < 0 )
+		cout << checksum;
+
+	Measurement measurement;
+	measurement.variant = variant;
+	measurement.packingFactor = packingFactor;
+	measurement.tableSize = table.size( );
+	measurement.meanProbes = totalProbes / ( double )table.elements( );
+	measurement.insertNs = insertSeconds * 1e9 / table.elements( );
+	measurement.findNs = ( repeats > 0 ) ? sum / repeats : 0.0;
+	measurement.findNsStddev = ( repeats > 1 ) ? sqrt( fmax( 0.0, ( squares - sum * sum / repeats ) / ( repeats - 1 ) ) ) : 0.0;
+	measurement.findNsMin = fastest;
+	measurement.throughput = ( measurement.insertNs + fastest > 0.0 ) ? 2e3 / ( measurement.insertNs + fastest ) : 0.0;
+	measurement.samples = repeats;
+	measurement.bytesPerKey = ( double )table.memory( ) / table.elements( );
+	measurements.push_back( measurement );
+}
+
+/*--- Writes the given hardware counters divided by the number of operations. ---*/
+void saveCounters( const perf_counters & counters, int operations, ofstream & outFile ) {
+
+	for( int i = 0; i < perf_counters::COUNTERS; i++ ) {
+
+		long long value = counters.value( ( perf_counters::Counter ) i );
+
+		/*--- The counter could not be read. ---*/
+		if( value < 0 )
+			outFile << "n/a";
+
+		else
+			outFile << round_func( ( double ) value / ( double ) operations, 2 );
+
+		outFile << "\t\t";
+	}
+
+	outFile << endl;
+}
+
+/* Inserts the elements into the given table and then finds them, writing
+ * the hardware counters per operation of each phase next to the mean
+ * number of probes.
+*/
+template < class Table >
+void profile( Table & table, const char * method, double packingFactor, const vector< int > & list,
+	int elements, perf_counters & counters, ofstream & outFile ) {
+
+	/*--- Insertion phase. ---*/
+	counters.start( );
+	insert( table, list, elements );
+	counters.stop( );
+
+	outFile << method << "\t" << packingFactor << "\tinsert\t-\t\t";
+	saveCounters( counters, elements, outFile );
+
+	/*--- Lookup phase. ---*/
+	double totalProbes = 0;
+	counters.start( );
+	for( int i = 0; i < elements; i++ )
+		totalProbes = totalProbes + table.find( list[ i ] ).getProbes( );
+	counters.stop( );
+
+	outFile << method << "\t" << packingFactor << "\tfind\t" << round_func( totalProbes / elements, 5 ) << "\t\t";
+	saveCounters( counters, elements, outFile );
+}
+
+/*--- Statistics gathered while replaying a trace. ---*/
+struct ReplayStatistics {
+
+	/*--- Wall time of the replay. ---*/
+	double seconds;
+
+	/*--- Outcome of the insertions. ---*/
+	size_t inserted, duplicates, full;
+
+	/*--- Outcome of the lookups, and the probes of the successful ones. ---*/
+	size_t hits, misses;
+	double probes;
+
+	/*--- Outcome of the removals. ---*/
+	size_t removed, notRemoved;
+};
+
+/*--- Removes a key, returns -1 if the table does not support removals. ---*/
+int removeKey( coalesced_hashing< int > & table, int key ) {
+
+	return table.remove( key );
+}
+
+/*--- Removes a key, returns -1 if the table does not support removals. ---*/
+int removeKey( bucketized_coalesced_hashing< int > &, int ) {
+
+	return -1;
+}
+
+/*--- Applies every operation of a trace to the given table. ---*/
+template < class Table >
+ReplayStatistics replay( Table & table, const vector< Operation > & operations ) {
+
+	ReplayStatistics statistics;
+	memset( &statistics, 0, sizeof( statistics ) );
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+
+	for( size_t i = 0; i < operations.size( ); i++ ) {
+
+		const Operation & operation = operations[ i ];
+		switch( operation.type ) {
+
+			case INSERT_OPERATION: {
+
+				InsertStatus status = table.try_insert( operation.key ).status;
+				if( status == INSERTED )
+					statistics.inserted++;
+
+				else if( status == DUPLICATE )
+					statistics.duplicates++;
+
+				else
+					statistics.full++;
+				break;
+			}
+
+			case FIND_OPERATION: {
+
+				const_ref< int > element = table.find( operation.key );
+				if( element.isNULL( ) )
+					statistics.misses++;
+
+				else {
+
+					statistics.hits++;
+					statistics.probes += element.getProbes( );
+				}
+				break;
+			}
+
+			case REMOVE_OPERATION: {
+
+				if( removeKey( table, operation.key ) > 0 )
+					statistics.removed++;
+
+				else
+					statistics.notRemoved++;
+				break;
+			}
+		}
+	}
+
+	statistics.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+	return statistics;
+}
+
+/*--- Prints the statistics of a replay. ---*/
+void saveReplay( const char * method, const ReplayStatistics & statistics, size_t operations, std::ostream & out ) {
+
+	double nanoseconds = statistics.seconds * 1e9 / ( operations > 0 ? operations : 1 );
+
+	out << method << "\t" << round_func( operations / statistics.seconds / 1e6, 3 ) << "\t\t";
+	out << round_func( nanoseconds, 1 ) << "\t\t";
+	out << statistics.inserted << "\t" << statistics.duplicates << "\t" << statistics.full << "\t";
+	out << statistics.hits << "\t" << statistics.misses << "\t";
+	out << round_func( statistics.hits > 0 ? statistics.probes / statistics.hits : 0.0, 5 ) << "\t\t";
+	out << statistics.removed << "\t" << statistics.notRemoved << endl;
+}
+
+/* Replays a trace against a table in cache mode, where a lookup that
+ * misses inserts the key as a read-through cache would.
+ * Returns the wall time of the replay.
+*/
+double replayCache( coalesced_hashing< int > & cache, const vector< Operation > & operations ) {
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+
+	for( size_t i = 0; i < operations.size( ); i++ ) {
+
+		const Operation & operation = operations[ i ];
+		if( operation.type == REMOVE_OPERATION )
+			cache.remove( operation.key );
+
+		else if( ( operation.type == INSERT_OPERATION ) || !cache.contains( operation.key ) )
+			cache.try_insert( operation.key );
+	}
+
+	return std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+}
+
+/* Generates a synthetic workload and writes it as a trace.
+ * app --generate <trace> [ options ]
+*/
+int generateMode( int argc, char* argv[ ] ) {
+
+	WorkloadSettings settings;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		const char * option = argv[ i ];
+		const char * value = argv[ i + 1 ];
+
+		if( strcmp( option, "--distribution" ) == 0 ) {
+
+			if( !parseDistribution( value, settings.distribution ) ) {
+
+				cout << "-->> Unknown distribution " << value << endl;
+				return 1;
+			}
+		}
+
+		else if( strcmp( option, "--operations" ) == 0 )
+			settings.operations = ( size_t )strtoull( value, NULL, 10 );
+
+		else if( strcmp( option, "--mix" ) == 0 ) {
+
+			/*--- insert,find,remove ---*/
+			if( sscanf( value, "%lf,%lf,%lf", &settings.insertRatio, &settings.findRatio, &settings.removeRatio ) < 2 ) {
+
+				cout << "-->> Expecting --mix insert,find[,remove]" << endl;
+				return 1;
+			}
+		}
+
+		else if( strcmp( option, "--hit-ratio" ) == 0 )
+			settings.hitRatio = atof( value );
+
+		else if( strcmp( option, "--skew" ) == 0 )
+			settings.zipfSkew = atof( value );
+
+		else if( strcmp( option, "--table-size" ) == 0 )
+			settings.tableSize = ( size_t )strtoull( value, NULL, 10 );
+
+		else if( strcmp( option, "--seed" ) == 0 )
+			settings.seed = strtoull( value, NULL, 10 );
+
+		else {
+
+			cout << "-->> Unknown option " << option << endl;
+			return 1;
+		}
+	}
+
+	cout << "Generating " << settings.operations << " operations, please wait..." << endl;
+	vector< Operation > operations = generateWorkload( settings );
+
+	if( !saveTrace( argv[ 2 ], settings.tableSize, operations ) ) {
+
+		cout << "-->> Cannot write trace " << argv[ 2 ] << endl;
+		return 1;
+	}
+
+	cout << "Done, trace written to " << argv[ 2 ] << endl;
+	return 0;
+}
+
+/* Replays a trace against every variant and writes <trace>.log.
+ * app --replay <trace> [ --table-size N ] [ --flooding-defense N ]
+ *                      [ --cache N [ --ttl S ] ]
+*/
+int replayMode( int argc, char* argv[ ] ) {
+
+	size_t tableSize = 0;
+	vector< Operation > operations;
+
+	cout << "Reading trace, please wait..." << endl;
+	if( !loadTrace( argv[ 2 ], tableSize, operations ) ) {
+
+		cout << "-->> Cannot read trace " << argv[ 2 ] << endl;
+		return 1;
+	}
+
+	/*--- Chain length that triggers a rehash of the classic tables, zero for none. ---*/
+	size_t maxChainLength = 0;
+
+	/*--- Slots and TTL of the cache the trace is also replayed against, zero for none. ---*/
+	size_t cacheSlots = 0;
+	double ttlSeconds = 0.0;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		if( strcmp( argv[ i ], "--table-size" ) == 0 )
+			tableSize = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else if( strcmp( argv[ i ], "--flooding-defense" ) == 0 )
+			maxChainLength = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else if( strcmp( argv[ i ], "--cache" ) == 0 )
+			cacheSlots = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else if( strcmp( argv[ i ], "--ttl" ) == 0 )
+			ttlSeconds = atof( argv[ i + 1 ] );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 1;
+		}
+	}
+
+	std::string logfile = std::string( argv[ 2 ] ) + ".log";
+	ofstream saveFile( logfile.c_str( ) );
+
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 4.1 REPLAY OF " << argv[ 2 ] << "( " << operations.size( ) << " OPERATIONS, TABLE SIZE = ";
+	saveFile << tableSize << " )" << endl;
+	saveFile << "Method\tMops/s\t\tns/op\t\tins\tdup\tfull\thit\tmiss\tprobes\t\trem\tnot rem" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+
+	const char * algorithmNames[ ] = { "EISCH", "LISCH", "EICH", "LICH" };
+	const char * bucketizedNames[ ] = { "BEISCH", "BLISCH", "BEICH", "BLICH" };
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		bool early = ( algorithm % 2 ) == 0;
+
+		cout << "-->> Replaying against " << algorithmNames[ algorithm ] << endl;
+		{
+			coalesced_hashing< int > table = ( algorithm < 2 ) ?
+				coalesced_hashing< int >( tableSize, early ) :
+				coalesced_hashing< int >( tableSize, early, ADDRESS_FACTOR );
+
+			if( maxChainLength > 0 )
+				table.enableFloodingDefense( maxChainLength );
+
+			saveReplay( algorithmNames[ algorithm ], replay( table, operations ), operations.size( ), saveFile );
+		}
+
+		cout << "-->> Replaying against " << bucketizedNames[ algorithm ] << endl;
+		{
+			bucketized_coalesced_hashing< int > table = ( algorithm < 2 ) ?
+				bucketized_coalesced_hashing< int >( tableSize, early ) :
+				bucketized_coalesced_hashing< int >( tableSize, early, ADDRESS_FACTOR );
+
+			saveReplay( bucketizedNames[ algorithm ], replay( table, operations ), operations.size( ), saveFile );
+		}
+	}
+
+	if( cacheSlots > 0 ) {
+
+		saveFile << endl;
+		saveFile << "--------------------------------------------------------------------";
+		saveFile << "----------------------------------------------------" << endl;
+		saveFile << "Table 4.2 READ-THROUGH CACHE OF " << cacheSlots << " SLOTS, TTL = " << ttlSeconds << " S" << endl;
+		saveFile << "Method	ns/op		hit ratio	hits	misses	evicted	expired" << endl;
+		saveFile << "--------------------------------------------------------------------";
+		saveFile << "----------------------------------------------------" << endl;
+
+		for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+			bool early = ( algorithm % 2 ) == 0;
+
+			cout << "-->> Replaying against a cache of " << algorithmNames[ algorithm ] << endl;
+			coalesced_hashing< int > cache = ( algorithm < 2 ) ?
+				coalesced_hashing< int >( cacheSlots, early ) :
+				coalesced_hashing< int >( cacheSlots, early, ADDRESS_FACTOR );
+			cache.enableCacheMode( ttlSeconds );
+
+			double seconds = replayCache( cache, operations );
+			CacheStatistics statistics = cache.cacheStatistics( );
+
+			saveFile << algorithmNames[ algorithm ] << "\t";
+			saveFile << round_func( seconds * 1e9 / ( operations.size( ) > 0 ? operations.size( ) : 1 ), 1 ) << "\t\t";
+			saveFile << round_func( cache.hitRatio( ), 5 ) << "\t\t";
+			saveFile << statistics.hits << "\t" << statistics.misses << "\t";
+			saveFile << statistics.evictions << "\t" << statistics.expirations << endl;
+		}
+	}
+
+	saveFile.close( );
+	cout << "Done, results written to " << logfile << endl;
+	return 0;
+}
+
+/* Bijective mixer, so the i-th benchmark key is distinct without storing it. */
+unsigned long long scaleKey( unsigned long long i ) {
+
+	i ^= i >> 30;
+	i *= 0xbf58476d1ce4e5b9ULL;
+	i ^= i >> 27;
+	i *= 0x94d049bb133111ebULL;
+	i ^= i >> 31;
+	return i;
+}
+
+template < class Link >
+int scaleBenchmark( size_t slots, double load ) {
+
+	cout << "Allocating " << slots << " slots, please wait..." << endl;
+	coalesced_hashing< unsigned long long, Link > table( slots, true, ADDRESS_FACTOR );
+
+	size_t keys = ( size_t )( table.size( ) * load );
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+	for( size_t i = 0; i < keys; i++ )
+		table.insert( scaleKey( i ) );
+	double insertNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / keys;
+
+	double totalProbes = 0;
+	begin = std::chrono::steady_clock::now( );
+	for( size_t i = 0; i < keys; i++ )
+		totalProbes += table.find( scaleKey( i ) ).getProbes( );
+	double findNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / keys;
+
+	/*--- Keys past the inserted range are guaranteed misses. ---*/
+	size_t misses = 0;
+	begin = std::chrono::steady_clock::now( );
+	for( size_t i = keys; i < 2 * keys; i++ )
+		misses += table.find( scaleKey( i ) ).isNULL( ) ? 1 : 0;
+	double missNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / keys;
+
+	cout << "Slots		" << table.size( ) << endl;
+	cout << "Keys		" << table.elements( ) << endl;
+	cout << "Link bytes	" << sizeof( Link ) << endl;
+	cout << "Bytes/key	" << ( double )table.memory( ) / table.elements( ) << endl;
+	cout << "ns/insert	" << insertNs << endl;
+	cout << "ns/hit		" << findNs << endl;
+	cout << "ns/miss		" << missNs << endl;
+	cout << "Mean probes	" << totalProbes / keys << endl;
+	return ( misses == keys ) ? 0 : 1;
+}
+
+/* Fills an EICH table of 64-bit keys sized in the billions.
+ * app --scale <slots> [ --load F ]
+*/
+int scaleMode( int argc, char* argv[ ] ) {
+
+	size_t slots = ( size_t )strtoull( argv[ 2 ], NULL, 10 );
+	double load = 0.9;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		if( strcmp( argv[ i ], "--load" ) == 0 )
+			load = atof( argv[ i + 1 ] );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 1;
+		}
+	}
+
+	/*--- 32-bit links while every slot is addressable, a third less memory per slot. ---*/
+	if( slots < 0xFFFFFFF0ULL )
+		return scaleBenchmark< unsigned int >( slots, load );
+
+	return scaleBenchmark< size_t >( slots, load );
+}
+
+#if defined( __cpp_impl_coroutine )
+/*--- Request of the interleaved benchmark, a few lookups in a row. ---*/
+lookup_task lookupRequest( const coalesced_hashing< unsigned long long > & table, size_t first, size_t count, size_t & hits ) {
+
+	for( size_t i = first; i < first + count; i++ ) {
+
+		const_ref< unsigned long long > found = co_await table.async_find( scaleKey( i ) );
+		if( !found.isNULL( ) )
+			hits++;
+	}
+}
+
+/* Looks up the same keys with find( ) one after the other, then from
+ * requests of four lookups interleaved by a lookup_scheduler.
+ * app --async <slots> [ --width N ]
+*/
+int asyncMode( int argc, char* argv[ ] ) {
+
+	size_t slots = ( size_t )strtoull( argv[ 2 ], NULL, 10 );
+	size_t width = 16;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		if( strcmp( argv[ i ], "--width" ) == 0 )
+			width = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 1;
+		}
+	}
+
+	coalesced_hashing< unsigned long long > table( slots, true, ADDRESS_FACTOR );
+	size_t keys = ( size_t )( table.size( ) * 0.9 );
+	for( size_t i = 0; i < keys; i++ )
+		table.insert( scaleKey( i ) );
+
+	/*--- Every other lookup misses. ---*/
+	size_t lookups = 2 * keys;
+	size_t sequentialHits = 0;
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+	for( size_t i = 0; i < lookups; i++ )
+		sequentialHits += table.find( scaleKey( i ) ).isNULL( ) ? 0 : 1;
+	double sequentialNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / lookups;
+
+	size_t interleavedHits = 0;
+	lookup_scheduler scheduler( width );
+	for( size_t first = 0; first < lookups; first += 4 )
+		scheduler.spawn( lookupRequest( table, first, ( lookups - first < 4 ) ? lookups - first : 4, interleavedHits ) );
+
+	begin = std::chrono::steady_clock::now( );
+	scheduler.run( );
+	double interleavedNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / lookups;
+
+	cout << "Slots		" << table.size( ) << endl;
+	cout << "Lookups		" << lookups << endl;
+	cout << "Width		" << width << endl;
+	cout << "ns/find		" << sequentialNs << endl;
+	cout << "ns/async_find	" << interleavedNs << endl;
+	return ( interleavedHits == sequentialHits ) ? 0 : 1;
+}
+#endif
+
+/* Logs insertions and removals to a durable EISCH table in the given directory,
+ * then opens it again as after a restart and times the recovery.
+ * app --durable <directory> [ --operations N ] [ --sync N ] [ --checkpoint N ]
+*/
+int durableMode( int argc, char* argv[ ] ) {
+
+	size_t operations = 1000000;
+	size_t syncInterval = 64;
+	size_t checkpointInterval = 0;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		if( strcmp( argv[ i ], "--operations" ) == 0 )
+			operations = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else if( strcmp( argv[ i ], "--sync" ) == 0 )
+			syncInterval = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else if( strcmp( argv[ i ], "--checkpoint" ) == 0 )
+			checkpointInterval = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 1;
+		}
+	}
+
+	/*--- Room for every key, a quarter of the operations remove one. ---*/
+	size_t tableSize = operations + operations / 4 + 1;
+	size_t stored = 0;
+	double logNs = 0.0, slowestUs = 0.0;
+
+	try {
+
+		durable_coalesced_hashing< int > table( argv[ 2 ], tableSize, true );
+		table.setSyncInterval( syncInterval );
+		table.setCheckpointInterval( checkpointInterval );
+
+		stored = table.elements( );
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+		for( size_t i = 0; i < operations; i++ ) {
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+
+			int key = ( int )( scaleKey( i ) & 0x7FFFFFFF );
+			if( ( i % 4 == 3 ) && ( table.remove( ( int )( scaleKey( i - 3 ) & 0x7FFFFFFF ) ) == 1 ) )
+				stored--;
+
+			else if( table.try_insert( key ).status == INSERTED )
+				stored++;
+
+			/*--- The operations that sync the log or start a checkpoint take the longest. ---*/
+			double us = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now( ) - start ).count( );
+			if( us > slowestUs )
+				slowestUs = us;
+		}
+		table.sync( );
+		logNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / operations;
+	}
+	catch( const DurabilityException & ) {
+
+		cout << "-->> Cannot use the table in " << argv[ 2 ] << endl;
+		return 1;
+	}
+
+	/*--- Open it again, as a restarted process would. ---*/
+	try {
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+		durable_coalesced_hashing< int > recovered( argv[ 2 ], tableSize, true );
+		double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+
+		cout << "Operations	" << operations << endl;
+		cout << "Sync every	" << syncInterval << endl;
+		cout << "ns/operation	" << logNs << endl;
+		cout << "Slowest us	" << slowestUs << endl;
+		cout << "Recovery s	" << seconds << endl;
+		cout << "Replayed	" << recovered.replayedOperations( ) << endl;
+		cout << "Replayed/s	" << ( seconds > 0.0 ? recovered.replayedOperations( ) / seconds : 0.0 ) << endl;
+		cout << "Keys		" << recovered.elements( ) << endl;
+		return ( recovered.elements( ) == stored ) ? 0 : 1;
+	}
+	catch( const DurabilityException & ) {
+
+		cout << "-->> Cannot recover the table in " << argv[ 2 ] << endl;
+		return 1;
+	}
+}
+
+/*--- Key inserted i-th by the shared mode and the set operations, an odd multiplier keeps them distinct. ---*/
+int spreadKey( size_t i ) {
+
+	return ( int )( ( unsigned int )i * 2654435761u );
+}
+
+#ifdef APP_SHARED_MEMORY
+
+/* Reads the shared table from a forked process while the writer fills it.
+ * Every record seen must be whole, and every key is found once the
+ * writer is done.  Returns the exit code of the reader.
+*/
+int sharedReader( const char * name, size_t operations ) {
+
+	try {
+
+		shared_coalesced_hashing< int > table( name );
+
+		/*--- Look the keys up while they are being inserted. ---*/
+		while( table.elements( ) < operations ) {
+
+			for( size_t i = 0; i < operations; i += 97 ) {
+
+				const int * found = table.try_find( spreadKey( i ) );
+				if( ( found != NULL ) && ( *found != spreadKey( i ) ) )
+					return 2;
+			}
+		}
+
+		for( size_t i = 0; i < operations; i++ )
+			if( !table.contains( spreadKey( i ) ) )
+				return 1;
+	}
+	catch( const SharedMemoryException & ) {
+
+		return 3;
+	}
+
+	return 0;
+}
+
+/* Fills a shared EISCH table while a forked reader looks it up.  Half way
+ * the writer lets go of the table and attaches again, as after a restart.
+ * app --shared <name> [ --operations N ]
+*/
+int sharedMode( int argc, char* argv[ ] ) {
+
+	size_t operations = 1000000;
+	for( int i = 3; i + 1 < argc; i += 2 ) {
+
+		if( strcmp( argv[ i ], "--operations" ) == 0 )
+			operations = ( size_t )strtoull( argv[ i + 1 ], NULL, 10 );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 1;
+		}
+	}
+
+	const char * name = argv[ 2 ];
+	double insertNs = 0.0;
+	pid_t reader = -1;
+	bool created = false;
+
+	try {
+
+		/*--- Create the table before the reader is forked, so it can attach at once. ---*/
+		shared_coalesced_hashing< int > * table = new shared_coalesced_hashing< int >( name, operations + operations / 9 + 1, true );
+		created = true;
+
+		cout.flush( );
+		reader = fork( );
+		if( reader == 0 )
+			_exit( sharedReader( name, operations ) );
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+		for( size_t i = 0; i < operations; i++ ) {
+
+			/*--- Restart the writer half way. ---*/
+			if( i == operations / 2 ) {
+
+				delete table;
+				table = new shared_coalesced_hashing< int >( name, true );
+			}
+
+			table->try_insert( spreadKey( i ) );
+		}
+		insertNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - begin ).count( ) / operations;
+
+		cout << "Operations	" << operations << endl;
+		cout << "ns/insert	" << insertNs << endl;
+		cout << "Keys		" << table->elements( ) << endl;
+		delete table;
+	}
+	catch( const SharedMemoryException & ) {
+
+		/*--- Never remove the segment of another table. ---*/
+		cout << "-->> Cannot use the shared memory segment " << name << endl;
+		if( created )
+			shared_coalesced_hashing< int >::remove( name );
+		return 1;
+	}
+
+	/*--- The reader tells how it went by its exit code. ---*/
+	int status = 0;
+	if( ( reader > 0 ) && ( waitpid( reader, &status, 0 ) == reader ) && WIFEXITED( status ) )
+		status = WEXITSTATUS( status );
+	else
+		status = 4;
+
+	const char * outcomes[ ] = { "every key found", "a key is missing", "a torn record", "cannot attach", "reader failed" };
+	cout << "Reader		" << outcomes[ status ] << endl;
+
+	shared_coalesced_hashing< int >::remove( name );
+	return ( status == 0 ) ? 0 : 1;
 }
+#endif
 
-/*--- Function to insert the integers into the coalesced hashing table. ---*/
-void insert( coalesced_hashing< int > & table, const vector< int > & list, int elements ) {
+/*--- Counts the objects emitted by a set operation, the context is the count. ---*/
+void countObject( const int &, void * context ) {
 
-	/*--- For the number of elements. ---*/
-	for( int i = 0; i < elements; i++ ) {
+	( *( size_t * )context )++;
+}
 
-		/*--- Insert element. ---*/
-		table.insert( list[ i ] );
-	}
+/* Looks every object of the scanned table up in the probed one, one find
+ * after the other, and counts those whose presence is the wanted one.
+ * Returns the elapsed seconds.
+*/
+double findLoop( const coalesced_hashing< int > & scanned, const coalesced_hashing< int > & probed, bool wanted, size_t & count ) {
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+
+	for( size_t pos = 0; pos < scanned.size( ); pos++ )
+		if( scanned.isOccupied( pos ) && ( probed.contains( scanned.objectAt( pos ) ) == wanted ) )
+			count++;
+
+	return std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
 }
 
-/*--- Save the results to file. ---*/
-void saveResults( const coalesced_hashing< int > & table, const vector< int > & list, ofstream & outFile ) {
+/*--- Looks every object of the stream up in the table, returns the elapsed seconds. ---*/
+double findLoop( const vector< int > & stream, const coalesced_hashing< int > & probed, size_t & count ) {
 
-	/*--- Stores the combine probes for all the items searched for. ---*/
-	double totalProbes = 0;
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
 
-	/*--- Try to find all the items. ---*/
-	for( int i = 0; i < table.elements( ); i++ ) {
+	for( size_t i = 0; i < stream.size( ); i++ )
+		if( probed.contains( stream[ i ] ) )
+			count++;
+
+	return std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+}
 
-		/*--- Find the value within the table. ---*/
-		const_ref< int > element = table.find( list[ i ] );
+/* Runs the set operation of the given index, intersect, difference or
+ * semiJoin, and counts the objects emitted.  Returns the elapsed seconds.
+*/
+double setOperation( int operation, const coalesced_hashing< int > & a, const coalesced_hashing< int > & b,
+	const vector< int > & stream, int threads, size_t & count ) {
 
-		/*--- Check if the element was found. ---*/
-		if( !element.isNULL( ) ) {
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
 
-			/*--- Get the number of probes. ---*/
-			totalProbes = totalProbes + element.getProbes( );
-		}
+	if( operation == 0 )
+		intersect( a, b, countObject, &count, threads );
+
+	else if( operation == 1 )
+		difference( a, b, countObject, &count, threads );
+
+	else
+		semiJoin( b, stream.data( ), stream.size( ), countObject, &count, threads );
+
+	return std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+}
+
+/* Writes the nanoseconds per key of the set operations on two EISCH tables
+ * sharing half of their keys, against a loop of finds doing the same work.
+*/
+void saveSetOperations( ofstream & saveFile ) {
+
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.5 NANOSECONDS PER KEY OF THE SET OPERATIONS AGAINST A FIND LOOP( TABLE SIZE = ";
+	saveFile << SET_TABLE_SIZE << ", PACKING FACTOR = 0.9 )" << endl;
+	saveFile << "Operation	Find loop	1 thread	" << std::thread::hardware_concurrency( ) << " thread(s)	Speedup		Emitted" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+
+	cout << "------------------------------------------------" << endl;
+	cout << "Timing the set operations, please wait..." << endl;
+
+	/*--- The second table holds the upper half of the keys of the first and as many others. ---*/
+	size_t elements = ( size_t )( SET_TABLE_SIZE * 0.9 );
+	coalesced_hashing< int > a( SET_TABLE_SIZE, true ), b( SET_TABLE_SIZE, true );
+	vector< int > stream;
+	for( size_t i = 0; i < elements; i++ ) {
+
+		a.insert( spreadKey( i ) );
+		b.insert( spreadKey( i + elements / 2 ) );
+		stream.push_back( spreadKey( i ) );
 	}
 
-	/*--- Print out the mean number of probes. ---*/
-	outFile << ( double )( totalProbes / ( double )table.elements( ) );
-	outFile << "\t\t";
+	const char * names[ ] = { "intersect", "difference", "semiJoin" };
+	for( int operation = 0; operation < 3; operation++ ) {
+
+		size_t expected = 0, single = 0, all = 0;
+		double loop = ( operation < 2 ) ? findLoop( a, b, operation == 0, expected ) : findLoop( stream, b, expected );
+		double one = setOperation( operation, a, b, stream, 1, single );
+		double every = setOperation( operation, a, b, stream, 0, all );
+
+		saveFile << names[ operation ] << "	" << round_func( loop * 1e9 / elements, 2 ) << "		";
+		saveFile << round_func( one * 1e9 / elements, 2 ) << "		" << round_func( every * 1e9 / elements, 2 ) << "		";
+		saveFile << round_func( loop / every, 2 ) << "		" << all;
+		if( ( single != expected ) || ( all != expected ) )
+			saveFile << " ( the find loop found " << expected << " )";
+
+		saveFile << endl;
+	}
+}
+
+/* Writes the probes and the nanoseconds per operation of the string tables
+ * at a packing factor of 0.9, half of the keys stored in the slots and half
+ * in the arena, then removes a tenth of them.
+*/
+void saveStringKeys( ofstream & saveFile, const vector< int > & list ) {
+
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.6 STRING KEYS IN COALESCED_STRING_HASHING( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << ", PACKING FACTOR = 0.9 )" << endl;
+	saveFile << "Method	Probes		ns/insert	ns/find		ns/remove	Arena bytes( full, after removals )" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+
+	/*--- Even keys fit in the slot, odd ones go to the arena. ---*/
+	int elements = ( int )round_func( TABLE_SIZE * 0.9, 0 );
+	vector< string > keys;
+	for( int i = 0; i < elements; i++ )
+		keys.push_back( ( i % 2 == 0 ) ? std::to_string( list[ i ] ) : "customer/" + std::to_string( list[ i ] ) + "/profile" );
+
+	const char * names[ ] = { "EISCH", "LISCH", "EICH", "LICH" };
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Storing string keys in " << names[ algorithm ] << ", please wait..." << endl;
+
+		bool early = ( algorithm % 2 ) == 0;
+		coalesced_string_hashing table = ( algorithm < 2 ) ?
+			coalesced_string_hashing( TABLE_SIZE, early ) :
+			coalesced_string_hashing( TABLE_SIZE, early, ADDRESS_FACTOR );
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now( );
+		for( int i = 0; i < elements; i++ )
+			table.insert( keys[ i ] );
+		double insertSeconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+
+		double totalProbes = 0;
+		begin = std::chrono::steady_clock::now( );
+		for( int i = 0; i < elements; i++ )
+			totalProbes += table.find( keys[ i ] ).getProbes( );
+		double findSeconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+
+		size_t fullArena = table.arenaSize( );
+
+		begin = std::chrono::steady_clock::now( );
+		for( int i = 0; i < elements / 10; i++ )
+			table.remove( keys[ i ] );
+		double removeSeconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - begin ).count( );
+
+		/*--- Every key left must still be found. ---*/
+		int missing = 0;
+		for( int i = elements / 10; i < elements; i++ )
+			if( !table.contains( keys[ i ] ) )
+				missing++;
+
+		saveFile << names[ algorithm ] << "	" << round_func( totalProbes / elements, 5 ) << "		";
+		saveFile << round_func( insertSeconds * 1e9 / elements, 2 ) << "		" << round_func( findSeconds * 1e9 / elements, 2 ) << "		";
+		saveFile << round_func( removeSeconds * 1e9 / ( elements / 10 ), 2 ) << "		" << fullArena << ", " << table.arenaSize( );
+		if( missing > 0 )
+			saveFile << " ( " << missing << " keys lost )";
+
+		saveFile << endl;
+	}
 }
 
 int main( int argc, char* argv[ ] ) {
 
+	/*--- Workload generation and trace replay. ---*/
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--generate" ) == 0 ) )
+		return generateMode( argc, argv );
+
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--replay" ) == 0 ) )
+		return replayMode( argc, argv );
+
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--scale" ) == 0 ) )
+		return scaleMode( argc, argv );
+
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--durable" ) == 0 ) )
+		return durableMode( argc, argv );
+
+#ifdef APP_SHARED_MEMORY
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--shared" ) == 0 ) )
+		return sharedMode( argc, argv );
+#endif
+
+#if defined( __cpp_impl_coroutine )
+	if( ( argc >= 3 ) && ( strcmp( argv[ 1 ], "--async" ) == 0 ) )
+		return asyncMode( argc, argv );
+#endif
+
 	/*--- Check the number of arguments. ---*/
-	if( argc != 2 ) {
+	if( argc < 2 ) {
 
 		cout << "Expecting a file list with integers." << endl;
 		cout << "In order to run this program, you must supply" << endl;
 		cout << "a file name as the first parameter." << endl;
+		cout << "Options: --perf  capture hardware counters per operation." << endl;
+		cout << "         --json <file> | --csv <file>  save the measurements." << endl;
+		cout << "         --repeat N  number of timed insertion and lookup passes, 5 by default." << endl;
+		cout << "         --compare <baseline> [ --current <run> ] [ --tolerance T ] [ --noise-floor NS ]" << endl;
+		cout << "                  fail on a regression, both options can be repeated." << endl;
+		cout << "Or:      --generate <trace> [ --distribution uniform|zipfian|sequential|adversarial ]" << endl;
+		cout << "                  [ --operations N ] [ --mix insert,find,remove ] [ --hit-ratio R ]" << endl;
+		cout << "                  [ --skew S ] [ --table-size N ] [ --seed N ]" << endl;
+		cout << "         --replay <trace> [ --table-size N ] [ --flooding-defense N ]" << endl;
+		cout << "                  [ --cache N [ --ttl S ] ]" << endl;
+		cout << "         --scale <slots> [ --load F ]" << endl;
+		cout << "         --durable <directory> [ --operations N ] [ --sync N ] [ --checkpoint N ]" << endl;
+		cout << "         --async <slots> [ --width N ]" << endl;
+		cout << "         --shared <name> [ --operations N ]" << endl;
 		return 0;
 	}
 
+	/*--- Read the options that follow the file name. ---*/
+	bool perfMode = false;
+	const char * jsonFile = NULL;
+	const char * csvFile = NULL;
+	vector< const char * > baselineFiles, currentFiles;
+	int repeats = 5;
+	double tolerance = 0.10;
+	double noiseFloor = 2.0;
+	for( int i = 2; i < argc; i++ ) {
+
+		if( strcmp( argv[ i ], "--perf" ) == 0 )
+			perfMode = true;
+
+		else if( ( strcmp( argv[ i ], "--json" ) == 0 ) && ( i + 1 < argc ) )
+			jsonFile = argv[ ++i ];
+
+		else if( ( strcmp( argv[ i ], "--csv" ) == 0 ) && ( i + 1 < argc ) )
+			csvFile = argv[ ++i ];
+
+		else if( ( strcmp( argv[ i ], "--compare" ) == 0 ) && ( i + 1 < argc ) )
+			baselineFiles.push_back( argv[ ++i ] );
+
+		else if( ( strcmp( argv[ i ], "--current" ) == 0 ) && ( i + 1 < argc ) )
+			currentFiles.push_back( argv[ ++i ] );
+
+		else if( ( strcmp( argv[ i ], "--repeat" ) == 0 ) && ( i + 1 < argc ) )
+			repeats = atoi( argv[ ++i ] );
+
+		else if( ( strcmp( argv[ i ], "--tolerance" ) == 0 ) && ( i + 1 < argc ) )
+			tolerance = atof( argv[ ++i ] );
+
+		else if( ( strcmp( argv[ i ], "--noise-floor" ) == 0 ) && ( i + 1 < argc ) )
+			noiseFloor = atof( argv[ ++i ] );
+
+		else {
+
+			cout << "-->> Unknown option " << argv[ i ] << endl;
+			return 0;
+		}
+	}
+
 	/*--- Stores the current number being read from the given file. ---*/
 	int currentNumber = 0;
 
@@ -153,6 +1214,9 @@ int main( int argc, char* argv[ ] ) {
 	saveFile << "----------------------------------------------------" << endl;
 	/*---------------------------------------------------------------------------------*/
 
+	/*--- Measurements of every variant for the JSON and CSV output. ---*/
+	vector< Measurement > measurements;
+
 	/*--- For the number of algorithms. ---*/
 	int elements = 0;
 	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
@@ -202,13 +1266,13 @@ int main( int argc, char* argv[ ] ) {
 					cout << "-->> Insert elements into the EISCH table with packing factor: " << packingFactor << endl;
 
 					/*--- Insert integers from the list into the Coalesced Hashing table. ---*/
-					insert( EISCH, list, elements );
+					double seconds = insert( EISCH, list, elements, repeats );
 
 					cout << "Done, inserting elements into the EISCH table." << endl << endl;
 					cout << "-->> Saving results for the EISCH Algorithm Method." << endl;
 
 					/*--- Saving results. ---*/
-					saveResults( EISCH, list, saveFile );
+					saveResults( EISCH, list, saveFile, "EISCH", packingFactor, seconds, repeats, measurements );
 
 					cout << "Done saving results for the EISCH Algorith Method." << endl;
 					cout << "--------------------------------------------------" << endl << endl;
@@ -224,12 +1288,12 @@ int main( int argc, char* argv[ ] ) {
 					cout << "-->> Insert elements into the LISCH table with packing factor: " << packingFactor << endl;
 				
 					/*--- Insert integers from the list into the Coalesced Hashing table. ---*/
-					insert( LISCH, list, elements );
+					double seconds = insert( LISCH, list, elements, repeats );
 
 					cout << "Done, inserting elements into the LISCH table." << endl << endl;
 					cout << "-->> Saving results for the LISCH Algorithm Method." << endl;
 
-					saveResults( LISCH, list, saveFile );
+					saveResults( LISCH, list, saveFile, "LISCH", packingFactor, seconds, repeats, measurements );
 
 					cout << "Done saving results for the LISCH Algorith Method." << endl;
 					cout << "--------------------------------------------------" << endl << endl;
@@ -244,12 +1308,12 @@ int main( int argc, char* argv[ ] ) {
 					cout << "-->> Insert elements into the EICH table with packing factor: " << packingFactor << endl;
 
 					/*--- Insert integers from the list into the Coalesced Hashing table. ---*/
-					insert( EICH, list, elements );
+					double seconds = insert( EICH, list, elements, repeats );
 
 					cout << "Done, inserting elements into the EICH table." << endl << endl;
 					cout << "-->> Saving results for the EICH Algorithm Method." << endl;
 
-					saveResults( EICH, list, saveFile );
+					saveResults( EICH, list, saveFile, "EICH", packingFactor, seconds, repeats, measurements );
 
 					cout << "Done saving results for the EICH Algorith Method." << endl;
 					cout << "--------------------------------------------------" << endl << endl;
@@ -264,12 +1328,12 @@ int main( int argc, char* argv[ ] ) {
 					cout << "-->> Insert elements into the LICH table with packing factor: " << packingFactor << endl;
 
 					/*--- Insert integers from the list into the Coalesced Hashing table. ---*/
-					insert( LICH, list, elements );
+					double seconds = insert( LICH, list, elements, repeats );
 
 					cout << "Done, inserting elements into the LICH table." << endl << endl;
 					cout << "-->> Saving results for the LICH Algorithm Method." << endl;
 
-					saveResults( LICH, list, saveFile );
+					saveResults( LICH, list, saveFile, "LICH", packingFactor, seconds, repeats, measurements );
 
 					cout << "Done saving results for the LICH Algorith Method." << endl;
 					cout << "--------------------------------------------------" << endl << endl;
@@ -277,44 +1341,362 @@ int main( int argc, char* argv[ ] ) {
 				}
 			}
 
-			/*--- If the Packing Factor is 0.8. ---*/
-			if( packingFactor == 0.8 ) {
+			/*--- Move on to the next packing factor. ---*/
+			packingFactor = nextPackingFactor( packingFactor );
+		}
 
-				/*--- Set the packing factor. ---*/
-				packingFactor = 0.9;
-				continue;
-			}
+		/*--- Go to the next line. ---*/
+		saveFile << endl;
+	}
 
-			/*--- If the Packing Factor is 0.9. ---*/
-			else if( packingFactor == 0.9 ) {
+	/*---- Create Table for the bucketized variants. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.1b MEAN NUMBER OF PROBES FOR SUCCESSFUL LOOKUP( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << " ) FOR\n BUCKETIZED VARIANTS OF COALESCED HASHING" << endl;
 
-				/*--- Set the packing factor. ---*/
-				packingFactor = 0.95;
-				continue;
-			}
+	saveFile << "  &\t0.2\t\t0.4\t\t0.6\t\t0.8\t\t0.9\t\t0.95\t\t0.99" << endl;
+	saveFile << "Method" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
 
-			/*--- If the Packing Factor is 0.9. ---*/
-			else if( packingFactor == 0.95 ) {
+	const char * bucketizedNames[ ] = { "BEISCH", "BLISCH", "BEICH", "BLICH" };
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
 
-				/*--- Set the packing factor. ---*/
-				packingFactor = 0.99;
-				continue;
-			}
+		cout << "------------------------------------------------" << endl;
+		cout << "Executing " << bucketizedNames[ algorithm ] << " Algorithm method, please wait..." << endl;
+		saveFile << bucketizedNames[ algorithm ] << "\t";
+
+		for( double packingFactor = 0.2; packingFactor < 1.0; packingFactor = nextPackingFactor( packingFactor ) ) {
+
+			/*--- Lets get the number of elements to read in. ---*/
+			elements = ( int )round_func( TABLE_SIZE * packingFactor, 0 );
+
+			/*--- The first two variants use the whole table as address region. ---*/
+			bool early = ( algorithm % 2 ) == 0;
+			bucketized_coalesced_hashing< int > table = ( algorithm < 2 ) ?
+				bucketized_coalesced_hashing< int >( TABLE_SIZE, early ) :
+				bucketized_coalesced_hashing< int >( TABLE_SIZE, early, ADDRESS_FACTOR );
+
+			cout << "-->> Insert elements into the " << bucketizedNames[ algorithm ] << " table with packing factor: " << packingFactor << endl;
+
+			/*--- Insert integers from the list into the table and save the results. ---*/
+			double seconds = insert( table, list, elements, repeats );
+			saveResults( table, list, saveFile, bucketizedNames[ algorithm ], packingFactor, seconds, repeats, measurements );
+		}
+
+		/*--- Go to the next line. ---*/
+		saveFile << endl;
+	}
+
+	/*---- Create Table for the frozen tables. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.1c MEAN NUMBER OF PROBES FOR SUCCESSFUL LOOKUP( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << " ) FOR\n VARIANTS OF COALESCED HASHING AFTER freeze( )" << endl;
+
+	saveFile << "  &\t0.2\t\t0.4\t\t0.6\t\t0.8\t\t0.9\t\t0.95\t\t0.99" << endl;
+	saveFile << "Method" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
+
+	const char * algorithmNames[ ] = { "EISCH", "LISCH", "EICH", "LICH" };
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Executing frozen " << algorithmNames[ algorithm ] << " Algorithm method, please wait..." << endl;
+		saveFile << algorithmNames[ algorithm ] << "\t";
+
+		for( double packingFactor = 0.2; packingFactor < 1.0; packingFactor = nextPackingFactor( packingFactor ) ) {
+
+			/*--- Lets get the number of elements to read in. ---*/
+			elements = ( int )round_func( TABLE_SIZE * packingFactor, 0 );
+
+			coalesced_hashing< int > table = createTable( algorithm );
+
+			cout << "-->> Insert and freeze elements in the " << algorithmNames[ algorithm ] << " table with packing factor: " << packingFactor << endl;
+
+			/*--- Build the table, relayout its chains and save the results. ---*/
+			double seconds = insert( table, list, elements, repeats );
+			table.freeze( );
+
+			string variant = string( algorithmNames[ algorithm ] ) + "-frozen";
+			saveResults( table, list, saveFile, variant.c_str( ), packingFactor, seconds, repeats, measurements );
+		}
+
+		/*--- Go to the next line. ---*/
+		saveFile << endl;
+	}
+
+	/*---- Create Table for the local cellars. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.1d MEAN NUMBER OF PROBES FOR SUCCESSFUL LOOKUP( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << " ) FOR\n VARIANTS OF COALESCED HASHING WITH LOCAL CELLARS" << endl;
+
+	saveFile << "  &\t0.2\t\t0.4\t\t0.6\t\t0.8\t\t0.9\t\t0.95\t\t0.99" << endl;
+	saveFile << "Method" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
+
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Executing " << algorithmNames[ algorithm ] << " Algorithm method with local cellars, please wait..." << endl;
+		saveFile << algorithmNames[ algorithm ] << "\t";
+
+		for( double packingFactor = 0.2; packingFactor < 1.0; packingFactor = nextPackingFactor( packingFactor ) ) {
+
+			/*--- Lets get the number of elements to read in. ---*/
+			elements = ( int )round_func( TABLE_SIZE * packingFactor, 0 );
+
+			/*--- One cellar per page of slots. ---*/
+			coalesced_hashing< int > table = createTable( algorithm );
+			table.enableLocalCellars( );
+
+			cout << "-->> Insert elements into the " << algorithmNames[ algorithm ] << " table with local cellars and packing factor: " << packingFactor << endl;
+
+			double seconds = insert( table, list, elements, repeats );
+
+			string variant = string( algorithmNames[ algorithm ] ) + "-local";
+			saveResults( table, list, saveFile, variant.c_str( ), packingFactor, seconds, repeats, measurements );
+		}
+
+		/*--- Go to the next line. ---*/
+		saveFile << endl;
+	}
+
+	/*---- Create Table for the compressed tables. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.1e MEAN NUMBER OF PROBES FOR SUCCESSFUL LOOKUP( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << " ) FOR\n VARIANTS OF COALESCED HASHING WITH COMPRESSED KEYS" << endl;
+
+	saveFile << "  &\t0.2\t\t0.4\t\t0.6\t\t0.8\t\t0.9\t\t0.95\t\t0.99" << endl;
+	saveFile << "Method" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
+
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Executing compressed " << algorithmNames[ algorithm ] << " Algorithm method, please wait..." << endl;
+		saveFile << algorithmNames[ algorithm ] << "\t";
+
+		for( double packingFactor = 0.2; packingFactor < 1.0; packingFactor = nextPackingFactor( packingFactor ) ) {
+
+			/*--- Lets get the number of elements to read in. ---*/
+			elements = ( int )round_func( TABLE_SIZE * packingFactor, 0 );
+
+			/*--- The last two variants use a cellar. ---*/
+			bool early = ( algorithm % 2 ) == 0;
+			compressed_coalesced_hashing< int > table = ( algorithm < 2 ) ?
+				compressed_coalesced_hashing< int >( TABLE_SIZE, early ) :
+				compressed_coalesced_hashing< int >( TABLE_SIZE, early, ADDRESS_FACTOR );
 
-			/*--- If the Packing Factor is 0.99. ---*/
-			else if( packingFactor == 0.99 )
-				break; /*--- Lets get out from this loop. ---*/
+			cout << "-->> Insert elements into the compressed " << algorithmNames[ algorithm ] << " table with packing factor: " << packingFactor << endl;
 
-			else
-				packingFactor += 0.2;
+			double seconds = insert( table, list, elements, repeats );
+
+			string variant = string( algorithmNames[ algorithm ] ) + "-compressed";
+			saveResults( table, list, saveFile, variant.c_str( ), packingFactor, seconds, repeats, measurements );
 		}
 
 		/*--- Go to the next line. ---*/
 		saveFile << endl;
 	}
 
+	/*---- Create Table for the membership filters. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.3 FALSE POSITIVE RATE OF THE COALESCED FILTER( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << ", PACKING FACTOR = 0.9 )" << endl;
+
+	saveFile << "Method\tBits\tMeasured\tExpected\tBytes/key" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
+
+	elements = ( int )round_func( TABLE_SIZE * 0.9, 0 );
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Executing the " << algorithmNames[ algorithm ] << " filter, please wait..." << endl;
+
+		for( int bits = 8; bits <= 16; bits += 4 ) {
+
+			bool early = ( algorithm % 2 ) == 0;
+			coalesced_filter< int > filter = ( algorithm < 2 ) ?
+				coalesced_filter< int >( TABLE_SIZE, early, bits ) :
+				coalesced_filter< int >( TABLE_SIZE, early, ADDRESS_FACTOR, bits );
+
+			for( int i = 0; i < elements; i++ )
+				filter.insert( list[ i ] );
+
+			/*--- The keys of the list are below 32768, so these ones were never inserted. ---*/
+			const int absent = 1000000;
+			int falsePositives = 0;
+			for( int i = 0; i < absent; i++ )
+				if( filter.contains( 32768 + i ) )
+					falsePositives++;
+
+			saveFile << algorithmNames[ algorithm ] << "\t" << bits << "\t";
+			saveFile << ( double )falsePositives / absent << "\t\t" << filter.expectedFalsePositiveRate( ) << "\t\t";
+			saveFile << ( double )filter.memory( ) / filter.elements( ) << endl;
+		}
+	}
+
+	/*---- Create Table for the aged tables. ---*/
+	/*---------------------------------------------------------------------------------*/
+	saveFile << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	saveFile << "Table 3.4 MEAN NUMBER OF PROBES OF AGED TABLES BEFORE AND AFTER DEFRAGMENTATION( TABLE SIZE = ";
+	saveFile << TABLE_SIZE << ", PACKING FACTOR = 0.9 )" << endl;
+
+	saveFile << "Method	Fresh		Aged		Defragmented	Rebuilt		Merged chains( fresh, aged, defragmented )" << endl;
+	saveFile << "--------------------------------------------------------------------";
+	saveFile << "----------------------------------------------------" << endl;
+	/*---------------------------------------------------------------------------------*/
+
+	elements = ( int )round_func( TABLE_SIZE * 0.9, 0 );
+	for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+		cout << "------------------------------------------------" << endl;
+		cout << "Aging " << algorithmNames[ algorithm ] << ", please wait..." << endl;
+
+		coalesced_hashing< int > table = createTable( algorithm );
+		vector< int > stored( list.begin( ), list.begin( ) + elements );
+		insert( table, list, elements );
+		ChainStatistics fresh = table.chainStatistics( );
+
+		/* Twenty rounds replacing the oldest tenth of the keys with new
+		 * ones, distinct and above the keys of the list.
+		*/
+		unsigned long long replaced = 0;
+		size_t oldest = 0;
+		for( int round = 0; round < 20; round++ )
+			for( int i = 0; i < elements / 10; i++, oldest++ ) {
+
+				int key = 32768 + ( int )( ( replaced++ * 2654435761ULL ) % 1000000007ULL );
+				table.remove( stored[ oldest ] );
+				table.insert( key );
+				stored.push_back( key );
+			}
+		ChainStatistics aged = table.chainStatistics( );
+
+		while( table.defragment( 4096 ) > 0 );
+		ChainStatistics defragmented = table.chainStatistics( );
+
+		/*--- The same keys inserted into an empty table. ---*/
+		coalesced_hashing< int > rebuilt = createTable( algorithm );
+		for( size_t i = oldest; i < stored.size( ); i++ )
+			rebuilt.insert( stored[ i ] );
+		ChainStatistics rebuiltChains = rebuilt.chainStatistics( );
+
+		saveFile << algorithmNames[ algorithm ] << "\t" << round_func( fresh.meanProbes, 5 ) << "\t\t";
+		saveFile << round_func( aged.meanProbes, 5 ) << "\t\t" << round_func( defragmented.meanProbes, 5 ) << "\t\t";
+		saveFile << round_func( rebuiltChains.meanProbes, 5 ) << "\t\t";
+		saveFile << fresh.mergedChains << ", " << aged.mergedChains << ", " << defragmented.mergedChains << endl;
+	}
+
+	/*---- Create Table for the set operations. ---*/
+	saveSetOperations( saveFile );
+
+	/*---- Create Table for the string keys. ---*/
+	saveStringKeys( saveFile, list );
+
+	/*---- Create Table for the hardware counters. ---*/
+	/*---------------------------------------------------------------------------------*/
+	if( perfMode ) {
+
+		perf_counters counters;
+		if( !counters.isAvailable( ) )
+			cout << "-->> Hardware counters are not available, they are reported as n/a." << endl;
+
+		saveFile << endl;
+		saveFile << "--------------------------------------------------------------------";
+		saveFile << "----------------------------------------------------" << endl;
+		saveFile << "Table 3.2 HARDWARE COUNTERS PER OPERATION( TABLE SIZE = ";
+		saveFile << TABLE_SIZE << " ) FOR\n VARIANTS OF COALESCED HASHING" << endl;
+
+		saveFile << "Method\t&\tOp\tProbes\t\t";
+		for( int i = 0; i < perf_counters::COUNTERS; i++ )
+			saveFile << perf_counters::name( ( perf_counters::Counter ) i ) << "\t";
+		saveFile << endl;
+		saveFile << "--------------------------------------------------------------------";
+		saveFile << "----------------------------------------------------" << endl;
+		/*---------------------------------------------------------------------------------*/
+
+		for( int algorithm = 0; algorithm < 4; algorithm++ ) {
+
+			cout << "------------------------------------------------" << endl;
+			cout << "Profiling " << algorithmNames[ algorithm ] << " and " << bucketizedNames[ algorithm ] << ", please wait..." << endl;
+
+			for( double packingFactor = 0.2; packingFactor < 1.0; packingFactor = nextPackingFactor( packingFactor ) ) {
+
+				elements = ( int )round_func( TABLE_SIZE * packingFactor, 0 );
+
+				coalesced_hashing< int > table = createTable( algorithm );
+				profile( table, algorithmNames[ algorithm ], packingFactor, list, elements, counters, saveFile );
+
+				bool early = ( algorithm % 2 ) == 0;
+				bucketized_coalesced_hashing< int > bucketized = ( algorithm < 2 ) ?
+					bucketized_coalesced_hashing< int >( TABLE_SIZE, early ) :
+					bucketized_coalesced_hashing< int >( TABLE_SIZE, early, ADDRESS_FACTOR );
+				profile( bucketized, bucketizedNames[ algorithm ], packingFactor, list, elements, counters, saveFile );
+			}
+		}
+	}
+
 	/*--- Close the file. ---*/
 	saveFile.close( );
 
+	/*--- Save the measurements. ---*/
+	if( ( jsonFile != NULL ) && !saveJson( jsonFile, measurements ) )
+		cout << "-->> Cannot write file " << jsonFile << endl;
+
+	if( ( csvFile != NULL ) && !saveCsv( csvFile, measurements ) )
+		cout << "-->> Cannot write file " << csvFile << endl;
+
+	/* Compare with the baseline, regressions make the run fail.  The runs
+	 * of every baseline file are taken together, and so are this run and
+	 * the earlier runs of the same build.
+	*/
+	if( !baselineFiles.empty( ) ) {
+
+		vector< Measurement > baseline;
+		for( size_t i = 0; i < baselineFiles.size( ); i++ )
+			if( !loadMeasurements( baselineFiles[ i ], baseline ) ) {
+
+				cout << "-->> Cannot read any measurement from file " << baselineFiles[ i ] << endl;
+				return 1;
+			}
+
+		for( size_t i = 0; i < currentFiles.size( ); i++ )
+			if( !loadMeasurements( currentFiles[ i ], measurements ) ) {
+
+				cout << "-->> Cannot read any measurement from file " << currentFiles[ i ] << endl;
+				return 1;
+			}
+
+		if( compareMeasurements( baseline, measurements, tolerance, noiseFloor, cout ) > 0 )
+			return 1;
+	}
+
 	return 0;
 }
@@ -0,0 +1,161 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include "perfcounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+
+/*--- Opens one counter for the calling thread on any CPU. ---*/
+static int openCounter( unsigned int type, unsigned long long config ) {
+
+	struct perf_event_attr attr;
+	memset( &attr, 0, sizeof( attr ) );
+	attr.size = sizeof( attr );
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	/*--- More counters than the PMU has are multiplexed, the times allow scaling. ---*/
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return ( int )syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+}
+
+/*--- Configuration of a hardware cache read miss counter. ---*/
+static unsigned long long cacheMiss( unsigned long long cache ) {
+
+	return cache | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+}
+#endif
+
+/*--- Constructor, opens the counters. ---*/
+perf_counters::perf_counters( ) {
+
+	for( int i = 0; i < COUNTERS; i++ ) {
+
+		fds[ i ] = -1;
+		values[ i ] = -1;
+	}
+
+#ifdef __linux__
+	fds[ CYCLES ] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+	fds[ INSTRUCTIONS ] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS );
+	fds[ L1D_MISSES ] = openCounter( PERF_TYPE_HW_CACHE, cacheMiss( PERF_COUNT_HW_CACHE_L1D ) );
+	fds[ LLC_MISSES ] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+	fds[ DTLB_MISSES ] = openCounter( PERF_TYPE_HW_CACHE, cacheMiss( PERF_COUNT_HW_CACHE_DTLB ) );
+	fds[ BRANCH_MISSES ] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES );
+#endif
+}
+
+/*--- Destructor, closes the counters. ---*/
+perf_counters::~perf_counters( ) {
+
+#ifdef __linux__
+	for( int i = 0; i < COUNTERS; i++ )
+		if( fds[ i ] != -1 )
+			close( fds[ i ] );
+#endif
+}
+
+/*--- Returns true if at least one counter could be opened. ---*/
+bool perf_counters::isAvailable( ) const {
+
+	for( int i = 0; i < COUNTERS; i++ )
+		if( fds[ i ] != -1 )
+			return true;
+
+	return false;
+}
+
+/*--- Resets and starts counting. ---*/
+void perf_counters::start( ) {
+
+#ifdef __linux__
+	for( int i = 0; i < COUNTERS; i++ ) {
+
+		if( fds[ i ] == -1 )
+			continue;
+
+		ioctl( fds[ i ], PERF_EVENT_IOC_RESET, 0 );
+		ioctl( fds[ i ], PERF_EVENT_IOC_ENABLE, 0 );
+	}
+#endif
+}
+
+/*--- Stops counting and reads the values. ---*/
+void perf_counters::stop( ) {
+
+#ifdef __linux__
+	/*--- Disable everything first, so reading does not count. ---*/
+	for( int i = 0; i < COUNTERS; i++ )
+		if( fds[ i ] != -1 )
+			ioctl( fds[ i ], PERF_EVENT_IOC_DISABLE, 0 );
+
+	for( int i = 0; i < COUNTERS; i++ ) {
+
+		values[ i ] = -1;
+
+		/*--- Value, time enabled and time running. ---*/
+		unsigned long long reading[ 3 ];
+		if( ( fds[ i ] == -1 ) || ( read( fds[ i ], reading, sizeof( reading ) ) != sizeof( reading ) ) )
+			continue;
+
+		/*--- A counter that never got on the PMU has no estimate. ---*/
+		if( reading[ 2 ] == 0 )
+			continue;
+
+		/*--- Extrapolate a multiplexed counter to the whole time it was enabled. ---*/
+		if( reading[ 2 ] < reading[ 1 ] )
+			values[ i ] = ( long long )( ( double )reading[ 0 ] * reading[ 1 ] / reading[ 2 ] );
+
+		else
+			values[ i ] = ( long long )reading[ 0 ];
+	}
+#endif
+}
+
+/* Returns the value read by the last stop( ), scaled up when the
+ * counter shared the PMU with others, or -1 if the counter is not
+ * available or was never scheduled.
+*/
+long long perf_counters::value( Counter counter ) const {
+
+	return values[ counter ];
+}
+
+/*--- Returns the name of the given counter. ---*/
+const char * perf_counters::name( Counter counter ) {
+
+	static const char * names[ COUNTERS ] = { "cycles", "instructions", "L1D-misses", "LLC-misses", "dTLB-misses", "branch-misses" };
+
+	return names[ counter ];
+}
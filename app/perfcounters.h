@@ -0,0 +1,84 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+/**
+ * Reads the hardware performance counters of the calling thread
+ * through the Linux perf_event_open interface.
+ *
+ * => Every counter is opened on its own, a counter the CPU or the
+ *    kernel does not expose is reported as unavailable while the
+ *    rest keep working.
+ *
+ * => On other platforms every counter is unavailable.
+*/
+
+class perf_counters {
+
+	public:
+
+		/*--- Counters that are captured. ---*/
+		enum Counter { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES, COUNTERS };
+
+		/*--- Constructor, opens the counters. ---*/
+		perf_counters( );
+
+		/*--- Destructor, closes the counters. ---*/
+		~perf_counters( );
+
+		/*--- Returns true if at least one counter could be opened. ---*/
+		bool isAvailable( ) const;
+
+		/*--- Resets and starts counting. ---*/
+		void start( );
+
+		/*--- Stops counting and reads the values. ---*/
+		void stop( );
+
+		/* Returns the value read by the last stop( ), scaled up when the
+		 * counter shared the PMU with others, or -1 if the counter is not
+		 * available or was never scheduled.
+		*/
+		long long value( Counter counter ) const;
+
+		/*--- Returns the name of the given counter. ---*/
+		static const char * name( Counter counter );
+
+	private:
+
+		/*--- Not copyable, the counters are owned. ---*/
+		perf_counters( const perf_counters & );
+		const perf_counters & operator=( const perf_counters & );
+
+		/*--- File descriptor of every counter, -1 when not available. ---*/
+		int fds[ COUNTERS ];
+
+		/*--- Values read by the last stop( ). ---*/
+		long long values[ COUNTERS ];
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "results.h"
+
+/*--- Writes the measurements as JSON, one measurement per line. ---*/
+bool saveJson( const char * file, const vector< Measurement > & measurements ) {
+
+	FILE * jsonFile = fopen( file, "w" );
+	if( jsonFile == NULL )
+		return false;
+
+	fprintf( jsonFile, "[\n" );
+	for( size_t i = 0; i < measurements.size( ); i++ ) {
+
+		const Measurement & m = measurements[ i ];
+		fprintf( jsonFile, "{\"variant\":\"%s\",\"packing_factor\":%.4f,\"table_size\":%zu,\"mean_probes\":%.6f,"
+			"\"insert_ns\":%.3f,\"find_ns\":%.3f,\"find_ns_stddev\":%.3f,\"find_ns_min\":%.3f,\"throughput\":%.3f,"
+			"\"samples\":%d,\"bytes_per_key\":%.3f}%s\n",
+			m.variant.c_str( ), m.packingFactor, m.tableSize, m.meanProbes, m.insertNs, m.findNs, m.findNsStddev,
+			m.findNsMin, m.throughput, m.samples, m.bytesPerKey, ( i + 1 < measurements.size( ) ) ? "," : "" );
+	}
+	fprintf( jsonFile, "]\n" );
+
+	return fclose( jsonFile ) == 0;
+}
+
+/*--- Writes the measurements as CSV with a header line. ---*/
+bool saveCsv( const char * file, const vector< Measurement > & measurements ) {
+
+	FILE * csvFile = fopen( file, "w" );
+	if( csvFile == NULL )
+		return false;
+
+	fprintf( csvFile, "variant,packing_factor,table_size,mean_probes,insert_ns,find_ns,find_ns_stddev,find_ns_min,throughput,samples,bytes_per_key\n" );
+	for( size_t i = 0; i < measurements.size( ); i++ ) {
+
+		const Measurement & m = measurements[ i ];
+		fprintf( csvFile, "%s,%.4f,%zu,%.6f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.3f\n", m.variant.c_str( ), m.packingFactor,
+			m.tableSize, m.meanProbes, m.insertNs, m.findNs, m.findNsStddev, m.findNsMin, m.throughput, m.samples, m.bytesPerKey );
+	}
+
+	return fclose( csvFile ) == 0;
+}
+
+/* Reads measurements written by saveJson or saveCsv, the format
+ * is taken from the file extension.  Returns false on failure,
+ * or when the file holds no measurement.
+*/
+bool loadMeasurements( const char * file, vector< Measurement > & measurements ) {
+
+	FILE * inFile = fopen( file, "r" );
+	if( inFile == NULL )
+		return false;
+
+	size_t length = strlen( file );
+	bool json = ( length >= 5 ) && ( strcmp( file + length - 5, ".json" ) == 0 );
+
+	size_t loaded = measurements.size( );
+	char line[ 1024 ];
+	while( fgets( line, sizeof( line ), inFile ) != NULL ) {
+
+		Measurement m;
+		char variant[ 128 ];
+		int fields;
+
+		if( json )
+			fields = sscanf( line, " {\"variant\":\"%127[^\"]\",\"packing_factor\":%lf,\"table_size\":%zu,\"mean_probes\":%lf,"
+				"\"insert_ns\":%lf,\"find_ns\":%lf,\"find_ns_stddev\":%lf,\"find_ns_min\":%lf,\"throughput\":%lf,"
+				"\"samples\":%d,\"bytes_per_key\":%lf", variant, &m.packingFactor, &m.tableSize, &m.meanProbes,
+				&m.insertNs, &m.findNs, &m.findNsStddev, &m.findNsMin, &m.throughput, &m.samples, &m.bytesPerKey );
+
+		else
+			fields = sscanf( line, "%127[^,],%lf,%zu,%lf,%lf,%lf,%lf,%lf,%lf,%d,%lf", variant, &m.packingFactor,
+				&m.tableSize, &m.meanProbes, &m.insertNs, &m.findNs, &m.findNsStddev, &m.findNsMin, &m.throughput,
+				&m.samples, &m.bytesPerKey );
+
+		/*--- Skip the header and the brackets. ---*/
+		if( fields != 11 )
+			continue;
+
+		m.variant = variant;
+		measurements.push_back( m );
+	}
+
+	fclose( inFile );
+	return measurements.size( ) > loaded;
+}
+
+/* Returns true if the current time is above the baseline one by more
+ * than the tolerance and the noise floor together.
+*/
+static bool slower( double baseline, double current, double tolerance, double noiseFloor ) {
+
+	return current > baseline * ( 1.0 + tolerance ) + noiseFloor;
+}
+
+/*--- Returns true if both rows measure the same variant, packing factor and table size. ---*/
+static bool sameMeasurement( const Measurement & a, const Measurement & b ) {
+
+	return ( a.variant == b.variant ) && ( fabs( a.packingFactor - b.packingFactor ) < 1e-6 ) && ( a.tableSize == b.tableSize );
+}
+
+/* Combines the rows of the runs measuring the same variant, packing factor
+ * and table size as the given one, keeping the fastest times of all of them.
+ * Returns false when no row matches.
+*/
+static bool fastest( const vector< Measurement > & runs, const Measurement & key, Measurement & best ) {
+
+	bool found = false;
+	for( size_t i = 0; i < runs.size( ); i++ ) {
+
+		const Measurement & run = runs[ i ];
+		if( !sameMeasurement( run, key ) )
+			continue;
+
+		if( !found ) {
+
+			best = run;
+			found = true;
+			continue;
+		}
+
+		best.insertNs = fmin( best.insertNs, run.insertNs );
+		best.findNsMin = fmin( best.findNsMin, run.findNsMin );
+		best.throughput = fmax( best.throughput, run.throughput );
+	}
+
+	return found;
+}
+
+/* Compares the current measurements with a baseline and writes a report.
+ * Returns the number of regressions, or one when no measurement matched.
+*/
+int compareMeasurements( const vector< Measurement > & baseline, const vector< Measurement > & current,
+	double tolerance, double noiseFloor, std::ostream & report ) {
+
+	int regressions = 0;
+	size_t matched = 0;
+	for( size_t i = 0; i < current.size( ); i++ ) {
+
+		/*--- Each measurement once, over all the runs of both sides. ---*/
+		bool seen = false;
+		for( size_t j = 0; ( j < i ) && !seen; j++ )
+			seen = sameMeasurement( current[ j ], current[ i ] );
+
+		Measurement now, before;
+		if( seen || !fastest( baseline, current[ i ], before ) )
+			continue;
+
+		fastest( current, current[ i ], now );
+
+		matched++;
+		if( now.meanProbes > before.meanProbes * ( 1.0 + tolerance ) ) {
+
+			report << "REGRESSION " << now.variant << " @ " << now.packingFactor << ": mean probes "
+				<< before.meanProbes << " -> " << now.meanProbes << std::endl;
+			regressions++;
+		}
+
+		if( now.bytesPerKey > before.bytesPerKey * ( 1.0 + tolerance ) ) {
+
+			report << "REGRESSION " << now.variant << " @ " << now.packingFactor << ": bytes per key "
+				<< before.bytesPerKey << " -> " << now.bytesPerKey << std::endl;
+			regressions++;
+		}
+
+		if( slower( before.insertNs, now.insertNs, tolerance, noiseFloor ) ) {
+
+			report << "REGRESSION " << now.variant << " @ " << now.packingFactor << ": ns per insert "
+				<< before.insertNs << " -> " << now.insertNs << std::endl;
+			regressions++;
+		}
+
+		if( slower( before.findNsMin, now.findNsMin, tolerance, noiseFloor ) ) {
+
+			report << "REGRESSION " << now.variant << " @ " << now.packingFactor << ": ns per find "
+				<< before.findNsMin << " -> " << now.findNsMin << std::endl;
+			regressions++;
+		}
+
+		/*--- The throughput compared through the nanoseconds per operation. ---*/
+		if( ( before.throughput > 0.0 ) && ( now.throughput > 0.0 ) &&
+			slower( 1e3 / before.throughput, 1e3 / now.throughput, tolerance, noiseFloor ) ) {
+
+			report << "REGRESSION " << now.variant << " @ " << now.packingFactor << ": throughput "
+				<< before.throughput << " -> " << now.throughput << " Mops/s" << std::endl;
+			regressions++;
+		}
+	}
+
+	if( matched == 0 ) {
+
+		report << "No measurement matched the baseline." << std::endl;
+		return 1;
+	}
+
+	report << matched << " measurement(s) compared, " << regressions << " regression(s) found." << std::endl;
+	return regressions;
+}
@@ -0,0 +1,96 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __RESULTS_H__
+#define __RESULTS_H__
+
+#include <stddef.h>
+#include <ostream>
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+/*--- One measurement of a variant at a packing factor. ---*/
+struct Measurement {
+
+	/*--- Name of the variant, for example EISCH. ---*/
+	string variant;
+
+	/*--- Ratio of elements to the table size. ---*/
+	double packingFactor;
+
+	/*--- Number of slots of the table. ---*/
+	size_t tableSize;
+
+	/*--- Mean number of probes for a successful lookup. ---*/
+	double meanProbes;
+
+	/*--- Nanoseconds per insertion, of the fastest pass. ---*/
+	double insertNs;
+
+	/*--- Mean and standard deviation of the nanoseconds per lookup over the samples. ---*/
+	double findNs;
+	double findNsStddev;
+
+	/*--- Nanoseconds per lookup of the fastest pass. ---*/
+	double findNsMin;
+
+	/*--- Millions of operations per second over the fastest insertion and lookup passes. ---*/
+	double throughput;
+
+	/*--- Number of timed insertion and lookup passes. ---*/
+	int samples;
+
+	/*--- Bytes of table per stored key. ---*/
+	double bytesPerKey;
+};
+
+/*--- Writes the measurements as JSON, one measurement per line. ---*/
+bool saveJson( const char * file, const vector< Measurement > & measurements );
+
+/*--- Writes the measurements as CSV with a header line. ---*/
+bool saveCsv( const char * file, const vector< Measurement > & measurements );
+
+/* Reads measurements written by saveJson or saveCsv, the format
+ * is taken from the file extension.  Returns false on failure,
+ * or when the file holds no measurement.
+*/
+bool loadMeasurements( const char * file, vector< Measurement > & measurements );
+
+/* Compares the current measurements with the baseline ones of the same
+ * variant, packing factor and table size, and writes a report.  Both sides
+ * may hold several independent runs, the fastest times of each measurement
+ * over its runs are compared, since the other processes of the machine can
+ * only slow a run down.  Probes and memory are deterministic, any growth
+ * beyond tolerance is a regression.  An insertion or lookup time is a
+ * regression when it grows by more than tolerance plus noiseFloor
+ * nanoseconds, and so is a throughput falling by as much.  Returns the
+ * number of regressions, or one when no measurement matched the baseline.
+*/
+int compareMeasurements( const vector< Measurement > & baseline, const vector< Measurement > & current,
+	double tolerance, double noiseFloor, std::ostream & report );
+
+#endif
@@ -0,0 +1,280 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <random>
+#include "workload.h"
+#include "primes.h"
+
+/**
+ * Synthetic workloads for the coalesced hashing tables, and the
+ * text trace format used to replay them.
+ *
+ * A trace starts with the line "T <table size>" followed by one
+ * operation per line: "I <key>", "F <key>" or "R <key>".
+*/
+
+/*--- Largest number of distinct keys the key generators can produce. ---*/
+static const unsigned long long KEY_SPACE = 0x80000000ULL;
+
+/* Returns the i-th key of the given distribution.  Every index maps
+ * to a different key, so keys past the inserted ones are misses.
+*/
+static int keyAt( KeyDistribution distribution, unsigned long long index, unsigned long long modulus ) {
+
+	switch( distribution ) {
+
+		case SEQUENTIAL:
+			return ( int )( index % KEY_SPACE );
+
+		case ADVERSARIAL: /*--- All of them hash to home address 0 with the identity hash. ---*/
+			return ( int )( ( index * modulus ) % KEY_SPACE );
+
+		default: { /*--- Xor-shifts and odd multipliers permute the 31-bit key space. ---*/
+
+			unsigned long long x = index % KEY_SPACE;
+			x ^= x >> 15;
+			x = ( x * 0x2C1B3C6DULL ) % KEY_SPACE;
+			x ^= x >> 12;
+			x = ( x * 0x297A2D39ULL ) % KEY_SPACE;
+			x ^= x >> 15;
+			return ( int )x;
+		}
+	}
+}
+
+/**
+ * Zipfian rank generator over a population that grows as keys are
+ * inserted ( Gray et al., "Quickly generating billion-record synthetic
+ * databases" ).  Rank 0 is the most popular.
+*/
+class zipfian_ranks {
+
+	public:
+
+		/*--- Constructor. ---*/
+		zipfian_ranks( double skew ) : theta( skew ), population( 0 ), zetan( 0.0 ) {
+
+			zeta2 = 1.0 + pow( 0.5, theta );
+		}
+
+		/*--- Adds one element to the population. ---*/
+		void grow( ) {
+
+			population++;
+			zetan += 1.0 / pow( ( double ) population, theta );
+		}
+
+		/*--- Removes the last element from the population. ---*/
+		void shrink( ) {
+
+			zetan -= 1.0 / pow( ( double ) population, theta );
+			population--;
+		}
+
+		/*--- Returns a rank given a uniform number in [ 0, 1 ). ---*/
+		size_t next( double u ) const {
+
+			double uz = u * zetan;
+			if( uz < 1.0 || population < 2 )
+				return 0;
+
+			if( uz < zeta2 )
+				return 1;
+
+			double alpha = 1.0 / ( 1.0 - theta );
+			double eta = ( 1.0 - pow( 2.0 / population, 1.0 - theta ) ) / ( 1.0 - zeta2 / zetan );
+			size_t rank = ( size_t )( population * pow( eta * u - eta + 1.0, alpha ) );
+
+			return rank < population ? rank : population - 1;
+		}
+
+	private:
+
+		double theta;
+		size_t population;
+		double zetan;
+		double zeta2;
+};
+
+/* Generates a stream of operations for the given settings.
+ * Inserted keys are always distinct, lookup misses use keys that are
+ * never inserted, and removals pick a key that is currently stored.
+*/
+vector< Operation > generateWorkload( const WorkloadSettings & settings ) {
+
+	std::mt19937_64 random( settings.seed );
+	std::uniform_real_distribution< double > uniform( 0.0, 1.0 );
+
+	/*--- The adversarial keys are multiples of the table prime. ---*/
+	unsigned long long modulus = nextPrime( settings.tableSize );
+
+	/*--- Normalize the mix of operations. ---*/
+	double total = settings.insertRatio + settings.findRatio + settings.removeRatio;
+	double insertShare = total > 0.0 ? settings.insertRatio / total : 1.0;
+	double findShare = total > 0.0 ? settings.findRatio / total : 0.0;
+
+	/*--- Misses come from the top of the key indexes, never inserted. ---*/
+	unsigned long long nextMiss = KEY_SPACE / modulus - 1;
+	if( settings.distribution != ADVERSARIAL )
+		nextMiss = KEY_SPACE - 1;
+
+	/*--- Keys currently stored, in insertion order. ---*/
+	vector< int > stored;
+	unsigned long long nextInsert = 0;
+	zipfian_ranks ranks( settings.zipfSkew );
+
+	vector< Operation > operations;
+	operations.reserve( settings.operations );
+	for( size_t i = 0; i < settings.operations; i++ ) {
+
+		Operation operation;
+		double choice = uniform( random );
+
+		/*--- Start with an insertion while the table is empty. ---*/
+		if( stored.empty( ) || choice < insertShare ) {
+
+			operation.type = INSERT_OPERATION;
+			operation.key = keyAt( settings.distribution, nextInsert++, modulus );
+			stored.push_back( operation.key );
+			ranks.grow( );
+		}
+
+		else if( choice < insertShare + findShare ) {
+
+			operation.type = FIND_OPERATION;
+
+			/*--- Lookup of a stored key. ---*/
+			if( uniform( random ) < settings.hitRatio ) {
+
+				size_t index;
+				if( settings.distribution == ZIPFIAN )
+					index = ranks.next( uniform( random ) );
+
+				else
+					index = ( size_t )( uniform( random ) * stored.size( ) ) % stored.size( );
+
+				operation.key = stored[ index ];
+			}
+
+			else /*--- Lookup of a key that is never inserted. ---*/
+				operation.key = keyAt( settings.distribution, nextMiss--, modulus );
+		}
+
+		else {
+
+			/*--- Remove a random stored key, the last one takes its place. ---*/
+			size_t index = ( size_t )( uniform( random ) * stored.size( ) ) % stored.size( );
+
+			operation.type = REMOVE_OPERATION;
+			operation.key = stored[ index ];
+			stored[ index ] = stored.back( );
+			stored.pop_back( );
+			ranks.shrink( );
+		}
+
+		operations.push_back( operation );
+	}
+
+	return operations;
+}
+
+/*--- Parses the name of a key distribution, returns false if unknown. ---*/
+bool parseDistribution( const char * name, KeyDistribution & distribution ) {
+
+	if( strcmp( name, "uniform" ) == 0 )
+		distribution = UNIFORM;
+
+	else if( strcmp( name, "zipfian" ) == 0 )
+		distribution = ZIPFIAN;
+
+	else if( strcmp( name, "sequential" ) == 0 )
+		distribution = SEQUENTIAL;
+
+	else if( strcmp( name, "adversarial" ) == 0 )
+		distribution = ADVERSARIAL;
+
+	else
+		return false;
+
+	return true;
+}
+
+/*--- Writes a trace, returns false on failure. ---*/
+bool saveTrace( const char * file, size_t tableSize, const vector< Operation > & operations ) {
+
+	FILE * traceFile = fopen( file, "w" );
+	if( traceFile == NULL )
+		return false;
+
+	static const char codes[ ] = { 'I', 'F', 'R' };
+
+	fprintf( traceFile, "T %zu\n", tableSize );
+	for( size_t i = 0; i < operations.size( ); i++ )
+		fprintf( traceFile, "%c %d\n", codes[ operations[ i ].type ], operations[ i ].key );
+
+	return fclose( traceFile ) == 0;
+}
+
+/*--- Reads a trace, returns false on failure. ---*/
+bool loadTrace( const char * file, size_t & tableSize, vector< Operation > & operations ) {
+
+	FILE * traceFile = fopen( file, "r" );
+	if( traceFile == NULL )
+		return false;
+
+	if( fscanf( traceFile, " T %zu", &tableSize ) != 1 ) {
+
+		fclose( traceFile );
+		return false;
+	}
+
+	char code;
+	Operation operation;
+	while( fscanf( traceFile, " %c %d", &code, &operation.key ) == 2 ) {
+
+		if( code == 'I' )
+			operation.type = INSERT_OPERATION;
+
+		else if( code == 'F' )
+			operation.type = FIND_OPERATION;
+
+		else if( code == 'R' )
+			operation.type = REMOVE_OPERATION;
+
+		else {
+
+			fclose( traceFile );
+			return false;
+		}
+
+		operations.push_back( operation );
+	}
+
+	fclose( traceFile );
+	return true;
+}
@@ -0,0 +1,102 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __WORKLOAD_H__
+#define __WORKLOAD_H__
+
+#include <stddef.h>
+#include <vector>
+using std::vector;
+
+/*--- How the keys of a workload are chosen. ---*/
+enum KeyDistribution {
+
+	UNIFORM,     /*--- Distinct keys spread over the whole integer range. ---*/
+	ZIPFIAN,     /*--- Uniform keys, lookups favour the first keys inserted. ---*/
+	SEQUENTIAL,  /*--- 0, 1, 2, ... ---*/
+	ADVERSARIAL  /*--- Multiples of the table size, all sharing one home address. ---*/
+};
+
+/*--- Kind of operation within a trace. ---*/
+enum OperationType { INSERT_OPERATION, FIND_OPERATION, REMOVE_OPERATION };
+
+/*--- One operation of a trace. ---*/
+struct Operation {
+
+	/*--- Operation to apply. ---*/
+	OperationType type;
+
+	/*--- Key the operation applies to. ---*/
+	int key;
+};
+
+/*--- Settings used to generate a workload. ---*/
+struct WorkloadSettings {
+
+	/*--- How the keys are chosen. ---*/
+	KeyDistribution distribution;
+
+	/*--- Number of operations to generate. ---*/
+	size_t operations;
+
+	/*--- Share of insertions, lookups and removals, they are normalized. ---*/
+	double insertRatio;
+	double findRatio;
+	double removeRatio;
+
+	/*--- Share of lookups for keys that were inserted. ---*/
+	double hitRatio;
+
+	/*--- Skew of the Zipfian lookups, between 0 and 1. ---*/
+	double zipfSkew;
+
+	/*--- Table size the trace is meant for. ---*/
+	size_t tableSize;
+
+	/*--- Seed of the random number generator. ---*/
+	unsigned long long seed;
+
+	/*--- Constructor with the default settings. ---*/
+	WorkloadSettings( ) : distribution( UNIFORM ), operations( 1000000 ), insertRatio( 0.5 ),
+		findRatio( 0.5 ), removeRatio( 0.0 ), hitRatio( 0.9 ), zipfSkew( 0.99 ),
+		tableSize( 2000003 ), seed( 1 ) { }
+};
+
+/* Generates a stream of operations for the given settings.
+ * Inserted keys are always distinct, lookup misses use keys that are
+ * never inserted, and removals pick a key that is currently stored.
+*/
+vector< Operation > generateWorkload( const WorkloadSettings & settings );
+
+/*--- Parses the name of a key distribution, returns false if unknown. ---*/
+bool parseDistribution( const char * name, KeyDistribution & distribution );
+
+/*--- Writes a trace, returns false on failure. ---*/
+bool saveTrace( const char * file, size_t tableSize, const vector< Operation > & operations );
+
+/*--- Reads a trace, returns false on failure. ---*/
+bool loadTrace( const char * file, size_t & tableSize, vector< Operation > & operations );
+
+#endif
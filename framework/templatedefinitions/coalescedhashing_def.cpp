@@ -25,7 +25,34 @@
 
 #include "const_Ref.cpp"
 #include "coalescedhashing.cpp"
+#include "coalescedsnapshot.cpp"
+#include "bucketizedcoalescedhashing.cpp"
+#include "setoperations.cpp"
+#include "sharedcoalescedhashing.cpp"
+#include "compressedcoalescedhashing.cpp"
+#include "coalescedfilter.cpp"
+#include "durablecoalescedhashing.cpp"
 
 /*--- This will get rid of the compiler/linking errors. ---*/
 template class const_ref< int >;
-template class coalesced_hashing< int >;
\ No newline at end of file
+template class const_ref< unsigned long long >;
+template class coalesced_hashing< int >;
+template class coalesced_hashing< int, unsigned int >;
+template class coalesced_hashing< unsigned long long >;
+template class coalesced_hashing< unsigned long long, unsigned int >;
+template class coalesced_snapshot< int >;
+template class bucketized_coalesced_hashing< int >;
+template class shared_coalesced_hashing< int >;
+template class compressed_coalesced_hashing< int >;
+template class compressed_coalesced_hashing< unsigned long long >;
+template class coalesced_filter< int >;
+template class durable_coalesced_hashing< int >;
+
+typedef void ( *IntCallback )( const int & object, void * context );
+template size_t intersect< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, IntCallback, void *, int );
+template size_t intersect< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, coalesced_hashing< int > &, int );
+template size_t unite< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, IntCallback, void *, int );
+template size_t unite< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, coalesced_hashing< int > &, int );
+template size_t difference< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, IntCallback, void *, int );
+template size_t difference< int >( const coalesced_hashing< int > &, const coalesced_hashing< int > &, coalesced_hashing< int > &, int );
+template size_t semiJoin< int >( const coalesced_hashing< int > &, const int *, size_t, IntCallback, void *, int );
\ No newline at end of file
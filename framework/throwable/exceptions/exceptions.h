@@ -31,5 +31,10 @@ class ItemNotFoundException  { public: ItemNotFoundException( )  { } };
 class DuplicateItemException { public: DuplicateItemException( ) { } };
 class IsFullException        { public: IsFullException( )        { } };
 class NullPointerException   { public: NullPointerException( )   { } };
+class IsFrozenException      { public: IsFrozenException( )      { } };
+class SharedMemoryException  { public: SharedMemoryException( )  { } };
+class DurabilityException    { public: DurabilityException( )    { } };
+class IsCacheException       { public: IsCacheException( )       { } };
+class KeyTooLongException    { public: KeyTooLongException( )    { } };
 
 #endif
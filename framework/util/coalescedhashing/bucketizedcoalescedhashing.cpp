@@ -0,0 +1,413 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <string.h>
+#include "bucketizedcoalescedhashing.h"
+#include "hashingfunction.h"
+#include "primes.h"
+#include "exceptions.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define BUCKETIZED_USE_SSE2
+#endif
+
+/**
+ * A data structure which implements bucketized coalesced hashing.
+ *
+ * => Every home address is a 64-byte bucket holding several records
+ *    together with a one-byte tag per record.
+ *
+ * => A bucket only spills when all of its lanes are taken, the spill
+ *    chain then follows the coalesced hashing variant in use.
+*/
+
+/*--- Constructor. ---*/
+template < class Object >
+bucketized_coalesced_hashing< Object >::bucketized_coalesced_hashing( size_t size, bool eisch )
+	: array( nextPrime( ( size + BUCKET_SLOTS - 1 ) / BUCKET_SLOTS ) ), eisch_algorithm( eisch ) {
+
+	/*--- The largest link value marks the end of a spill chain. ---*/
+	if( array.size( ) * BUCKET_SLOTS >= ( size_t )NO_LINK )
+		throw IsFullException( );
+
+	/*--- Default address factor. ---*/
+	addressFactor = -1.0;
+
+	/*--- Clear array. ---*/
+	clear( );
+}
+
+/*--- Constructor. ---*/
+template < class Object >
+bucketized_coalesced_hashing< Object >::bucketized_coalesced_hashing( size_t size, bool eich, const double & addressFactor )
+	: array( nextPrime( ( size + BUCKET_SLOTS - 1 ) / BUCKET_SLOTS ) ), eisch_algorithm( eich ) {
+
+	/*--- The largest link value marks the end of a spill chain. ---*/
+	if( array.size( ) * BUCKET_SLOTS >= ( size_t )NO_LINK )
+		throw IsFullException( );
+
+	/*--- Set address factor. ---*/
+	this->addressFactor = addressFactor;
+
+	/*--- Default in case is less than zero or greater than 1. ---*/
+	if( ( this->addressFactor < 0.0 ) || ( this->addressFactor > 1.0 ) )
+		this->addressFactor = 0.86;
+
+	/*--- Clear array. ---*/
+	clear( );
+}
+
+/*--- Insert into the table. ---*/
+template < class Object >
+void bucketized_coalesced_hashing< Object >::insert( const Object & object ) {
+
+	/*--- Try to insert the item. ---*/
+	InsertResult result = try_insert( object );
+
+	if( result.status == DUPLICATE ) /*--- Already stored. ---*/
+		throw DuplicateItemException( );
+
+	else if( result.status == FULL ) /*--- No empty lane left. ---*/
+		throw IsFullException( );
+}
+
+/* Insert into the table without throwing.
+ * Returns the status together with the slot of the object.
+*/
+template < class Object >
+InsertResult bucketized_coalesced_hashing< Object >::try_insert( const Object & object ) {
+
+	/*--- Get the home bucket and the tag of the object. ---*/
+	size_t bucket = findPos( object );
+	unsigned char tag = tagOf( object );
+
+	/*--- Search the home bucket and its spill chain. ---*/
+	SearchedResult result = findInProbeChain( object, bucket, tag );
+	if( result.probes > 0 ) { /*--- Already stored. ---*/
+
+		InsertResult duplicate = { DUPLICATE, result.pos };
+		return duplicate;
+	}
+
+	/*--- If there is an empty lane in the home bucket, use it. ---*/
+	unsigned int freeLanes = matchTags( bucket, 0 );
+	if( freeLanes != 0 ) {
+
+		size_t lane = 0;
+		while( !( freeLanes & ( 1u << lane ) ) )
+			lane++;
+
+		Bucket & home = array[ bucket ];
+		home.tags[ lane ] = tag;
+		home.objects[ lane ] = object;
+		home.links[ lane ] = NO_LINK;
+
+		occupied++;
+
+		InsertResult inserted = { INSERTED, bucket * BUCKET_SLOTS + lane };
+		return inserted;
+	}
+
+	/* The bucket is full, find the bottommost empty lane in the table.
+	 * If none is found, report a "full table".
+	*/
+	while( ( unoccupiedPos != END_OF_CHAIN ) &&
+		( array[ unoccupiedPos / BUCKET_SLOTS ].tags[ unoccupiedPos % BUCKET_SLOTS ] != 0 ) )
+		unoccupiedPos--;
+
+	if( unoccupiedPos == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	/* A full bucket that never spilled, but holds records spilled by
+	 * other buckets, continues the list of the first of them, just as
+	 * a home slot taken by another record does in coalesced_hashing.
+	*/
+	Bucket & home = array[ bucket ];
+	if( home.chain == NO_LINK ) {
+
+		size_t lane = foreignLane( bucket );
+		if( lane != BUCKET_SLOTS ) {
+
+			home.chain = ( unsigned int )( bucket * BUCKET_SLOTS + lane );
+			result = findInProbeChain( object, bucket, tag );
+		}
+	}
+
+	/*--- Insert the item into the unoccupied lane. ---*/
+	Bucket & spill = array[ unoccupiedPos / BUCKET_SLOTS ];
+	size_t lane = unoccupiedPos % BUCKET_SLOTS;
+	spill.tags[ lane ] = tag;
+	spill.objects[ lane ] = object;
+	spill.links[ lane ] = NO_LINK;
+
+	/* Link the new record into the spill chain of its home bucket,
+	 * at the end for late insertion, first for early insertion.  A
+	 * chain that continues another list keeps the record it enters
+	 * that list at in front, so the other list is never cut.
+	*/
+	if( result.pos == END_OF_CHAIN )
+		home.chain = ( unsigned int ) unoccupiedPos;
+
+	else if( !eisch_algorithm )
+		array[ result.pos / BUCKET_SLOTS ].links[ result.pos % BUCKET_SLOTS ] = ( unsigned int ) unoccupiedPos;
+
+	else if( home.chain / BUCKET_SLOTS == bucket ) {
+
+		spill.links[ lane ] = home.links[ home.chain % BUCKET_SLOTS ];
+		home.links[ home.chain % BUCKET_SLOTS ] = ( unsigned int ) unoccupiedPos;
+	}
+
+	else {
+
+		spill.links[ lane ] = home.chain;
+		home.chain = ( unsigned int ) unoccupiedPos;
+	}
+
+	/*--- Increase occupied variable. ---*/
+	occupied++;
+
+	InsertResult inserted = { INSERTED, unoccupiedPos };
+	return inserted;
+}
+
+/*--- Find an item from the table. ---*/
+template < class Object >
+const_ref< Object > bucketized_coalesced_hashing< Object >::find( const Object & object ) const {
+
+	/*--- Search the home bucket and its spill chain. ---*/
+	SearchedResult result = findInProbeChain( object, findPos( object ), tagOf( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return const_ref< Object >( );
+
+	const Bucket & bucket = array[ result.pos / BUCKET_SLOTS ];
+	size_t lane = result.pos % BUCKET_SLOTS;
+	size_t linkpos = bucket.links[ lane ] == NO_LINK ? END_OF_CHAIN : bucket.links[ lane ];
+
+	/*--- return the object. ---*/
+	return const_ref< Object >( bucket.objects[ lane ], linkpos, result.probes );
+}
+
+/*--- Returns true if the item is stored in the table. ---*/
+template < class Object >
+bool bucketized_coalesced_hashing< Object >::contains( const Object & object ) const {
+
+	return findInProbeChain( object, findPos( object ), tagOf( object ) ).probes > 0;
+}
+
+/* Find an item from the table without throwing.
+ * Returns NULL when the item is not stored.
+*/
+template < class Object >
+const Object * bucketized_coalesced_hashing< Object >::try_find( const Object & object ) const {
+
+	SearchedResult result = findInProbeChain( object, findPos( object ), tagOf( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return NULL;
+
+	return &array[ result.pos / BUCKET_SLOTS ].objects[ result.pos % BUCKET_SLOTS ];
+}
+
+/*--- Empty the table logically. ---*/
+template < class Object >
+void bucketized_coalesced_hashing< Object >::clear( ) {
+
+	occupied = 0;
+
+	/*--- Last slot of the table. ---*/
+	unoccupiedPos = array.size( ) * BUCKET_SLOTS - 1;
+
+	/*--- Clear the buckets. ---*/
+	for( size_t i = 0; i < array.size( ); i++ ) {
+
+		/*--- Make every lane logically empty. ---*/
+		memset( array[ i ].tags, 0, sizeof( array[ i ].tags ) );
+
+		/*--- No spill chain. ---*/
+		array[ i ].chain = NO_LINK;
+	}
+}
+
+/*--- Empties the table physically. ---*/
+template < class Object >
+void bucketized_coalesced_hashing< Object >::empty( ) {
+
+	occupied = 0;
+	unoccupiedPos = END_OF_CHAIN;
+
+	/*--- Remove everything. ---*/
+	vector< Bucket >( ).swap( array );
+}
+
+/*--- Returns the number of items currently within the table. ---*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::elements( ) const {
+
+	return occupied;
+}
+
+/*--- Returns the number of slots within the table. ---*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::size( ) const {
+
+	return array.size( ) * BUCKET_SLOTS;
+}
+
+/*--- Returns the number of buckets within the table. ---*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::buckets( ) const {
+
+	return array.size( );
+}
+
+/*--- Returns the number of bytes used by the buckets of the table. ---*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::memory( ) const {
+
+	return array.capacity( ) * sizeof( Bucket );
+}
+
+/*--- Returns the home bucket for the given object. ---*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::findPos( const Object & obj ) const {
+
+	if( addressFactor != -1.0 )
+		return hash( obj ) % ( size_t )( addressFactor * array.size( ) );
+
+	return hash( obj ) % array.size( );
+}
+
+/* Searches the given object within its home bucket and then
+ * till the end of the spill chain.
+*/
+template < class Object >
+SearchedResult bucketized_coalesced_hashing< Object >::findInProbeChain( const Object & obj, size_t bucket, unsigned char tag ) const {
+
+	/*--- To Store the Search Result. ---*/
+	SearchedResult result;
+	result.probes = 1;
+	result.pos = END_OF_CHAIN;
+	result.length = 1;
+
+	/*--- Compare the records whose tag matches in the home bucket. ---*/
+	const Bucket & home = array[ bucket ];
+	unsigned int matches = matchTags( bucket, tag );
+	for( size_t lane = 0; matches != 0; lane++, matches >>= 1 ) {
+
+		if( ( matches & 1 ) && ( home.objects[ lane ] == obj ) ) {
+
+			result.pos = bucket * BUCKET_SLOTS + lane;
+			return result;
+		}
+	}
+
+	/*--- Walk the spill chain, one bucket per hop, into the lists it joined. ---*/
+	size_t pos = home.chain;
+	while( pos != NO_LINK ) {
+
+		const Bucket & spill = array[ pos / BUCKET_SLOTS ];
+		size_t lane = pos % BUCKET_SLOTS;
+
+		/*--- A lane of the home bucket was compared already. ---*/
+		bool inHome = ( pos / BUCKET_SLOTS == bucket );
+		if( !inHome ) {
+
+			result.probes++;
+			result.length++;
+		}
+
+		if( !inHome && ( spill.tags[ lane ] == tag ) && ( spill.objects[ lane ] == obj ) ) {
+
+			result.pos = pos;
+			return result;
+		}
+
+		/*--- Set the last item in the spill chain. ---*/
+		result.pos = pos;
+
+		/*--- find the next link position. ---*/
+		pos = spill.links[ lane ];
+	}
+
+	/*--- Not found. ---*/
+	result.probes = 0;
+	return result;
+}
+
+/* Returns the first lane of the bucket holding a record
+ * spilled by another bucket, BUCKET_SLOTS when there is none.
+*/
+template < class Object >
+size_t bucketized_coalesced_hashing< Object >::foreignLane( size_t bucket ) const {
+
+	const Bucket & home = array[ bucket ];
+	for( size_t lane = 0; lane < BUCKET_SLOTS; lane++ )
+		if( ( home.tags[ lane ] != 0 ) && ( findPos( home.objects[ lane ] ) != bucket ) )
+			return lane;
+
+	return BUCKET_SLOTS;
+}
+
+/* Returns a mask with bit i set when lane i
+ * of the bucket holds the given tag.
+*/
+template < class Object >
+unsigned int bucketized_coalesced_hashing< Object >::matchTags( size_t bucket, unsigned char tag ) const {
+
+#ifdef BUCKETIZED_USE_SSE2
+	/*--- Compare the eight tags with a single instruction. ---*/
+	__m128i tags = _mm_loadl_epi64( ( const __m128i * ) array[ bucket ].tags );
+	unsigned int mask = ( unsigned int ) _mm_movemask_epi8( _mm_cmpeq_epi8( tags, _mm_set1_epi8( ( char ) tag ) ) );
+#else
+	/*--- Compare the eight tags within a 64-bit word. ---*/
+	unsigned long long tags;
+	memcpy( &tags, array[ bucket ].tags, sizeof( tags ) );
+
+	const unsigned long long low = 0x7F7F7F7F7F7F7F7FULL;
+	unsigned long long x = tags ^ ( 0x0101010101010101ULL * tag );
+	unsigned long long zero = ~( ( ( x & low ) + low ) | x | low );
+
+	unsigned int mask = 0;
+	for( size_t lane = 0; lane < 8; lane++ )
+		if( zero & ( 0x80ULL << ( lane * 8 ) ) )
+			mask |= 1u << lane;
+#endif
+
+	/*--- Only the lanes in use by the bucket. ---*/
+	return mask & ( ( 1u << BUCKET_SLOTS ) - 1 );
+}
+
+/*--- Returns the tag stored beside the given object. ---*/
+template < class Object >
+unsigned char bucketized_coalesced_hashing< Object >::tagOf( const Object & obj ) {
+
+	/*--- Take the top bits of a multiplicative mix, the high bit marks the lane as used. ---*/
+	unsigned long long mixed = ( unsigned long long ) hash( obj ) * 0x9E3779B97F4A7C15ULL;
+
+	return ( unsigned char )( 0x80 | ( mixed >> 57 ) );
+}
@@ -0,0 +1,175 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __BUCKETIZED_COALESCED_HASHING_H__
+#define __BUCKETIZED_COALESCED_HASHING_H__
+
+#include "coalescedhashing.h"
+#include "const_ref.h"
+#include <vector>
+using std::vector;
+
+/**
+ * A data structure which implements bucketized coalesced hashing.
+ *
+ * => Every home address is a 64-byte bucket holding several records
+ *    together with a one-byte tag per record.  The tags of a bucket
+ *    are compared at once, so a lookup that ends in its home bucket
+ *    touches a single cache line.
+ *
+ * => A bucket only spills when all of its lanes are taken.  Spilled
+ *    records go to the bottommost empty lane of the table, and are
+ *    linked into the spill chain of their home bucket, early or late,
+ *    exactly as in coalesced_hashing.  With an address factor the
+ *    bottom buckets form the cellar.
+ *
+ * => The empty lanes are shared by every bucket, so a bucket can fill
+ *    up with records spilled by others.  When it spills in turn, its
+ *    chain continues the list of the first such record, and the lists
+ *    coalesce as the slots of coalesced_hashing do.
+ *
+ *    BLISCH (late insert standard coalesced hashing)
+ *    BEISCH (early insert standard coalesced hashing)
+ *    BLICH  (late insert coalesced hashing)
+ *    BEICH  (early insert coalesced hashing)
+*/
+
+template < class Object >
+class bucketized_coalesced_hashing {
+
+	public:
+
+		/*--- Number of records, with their links, that fit in a cache line. ---*/
+		static const size_t LANES = ( 64 - 12 ) / ( sizeof( Object ) + sizeof( unsigned int ) );
+
+		/*--- Number of records held by each bucket, one tag byte each. ---*/
+		static const size_t BUCKET_SLOTS = LANES > 8 ? 8 : ( LANES < 1 ? 1 : LANES );
+
+		/*--- Constructor. ---*/
+		bucketized_coalesced_hashing( size_t size, bool eisch );
+
+		/*--- Constructor. ---*/
+		bucketized_coalesced_hashing( size_t size, bool eich, const double & addressFactor );
+
+		/*--- Insert into the table. ---*/
+		void insert( const Object & object );
+
+		/* Insert into the table without throwing.
+		 * Returns the status together with the slot of the object.
+		*/
+		InsertResult try_insert( const Object & object );
+
+		/*--- Find an item from the table. ---*/
+		const_ref< Object > find( const Object & object ) const;
+
+		/*--- Returns true if the item is stored in the table. ---*/
+		bool contains( const Object & object ) const;
+
+		/* Find an item from the table without throwing.
+		 * Returns NULL when the item is not stored.
+		*/
+		const Object * try_find( const Object & object ) const;
+
+		/*--- Empty the table logically. ---*/
+		void clear( );
+
+		/*--- Empties the table physically. ---*/
+		void empty( );
+
+		/*--- Returns the number of items currently within the table. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the number of slots within the table. ---*/
+		size_t size( ) const;
+
+		/*--- Returns the number of buckets within the table. ---*/
+		size_t buckets( ) const;
+
+		/*--- Returns the number of bytes used by the buckets of the table. ---*/
+		size_t memory( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Returns the home bucket for the given object. ---*/
+		size_t findPos( const Object & obj ) const;
+
+		/* Searches the given object within its home bucket and then
+		 * till the end of the spill chain.  When the object is not
+		 * found, the position is the last slot of the spill chain,
+		 * or END_OF_CHAIN when the bucket never spilled.
+		*/
+		SearchedResult findInProbeChain( const Object & obj, size_t bucket, unsigned char tag ) const;
+
+		/* Returns the first lane of the bucket holding a record
+		 * spilled by another bucket, BUCKET_SLOTS when there is none.
+		*/
+		size_t foreignLane( size_t bucket ) const;
+
+		/* Returns a mask with bit i set when lane i
+		 * of the bucket holds the given tag.
+		*/
+		unsigned int matchTags( size_t bucket, unsigned char tag ) const;
+
+		/*--- Returns the tag stored beside the given object. ---*/
+		static unsigned char tagOf( const Object & obj );
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- Link value that marks the end of a spill chain. ---*/
+		static const unsigned int NO_LINK = 0xFFFFFFFF;
+
+		/*--- One cache line worth of records. ---*/
+		struct alignas( 64 ) Bucket {
+
+			/*--- Stores the tag of every lane, zero when the lane is empty. ---*/
+			unsigned char tags[ 8 ];
+
+			/*--- Stores the records. ---*/
+			Object objects[ BUCKET_SLOTS ];
+
+			/*--- Link position of every lane within its spill chain. ---*/
+			unsigned int links[ BUCKET_SLOTS ];
+
+			/*--- First slot of the spill chain of this bucket. ---*/
+			unsigned int chain;
+		};
+
+		/*--- Stores the number of entries currently stored. ---*/
+		size_t occupied;
+
+		/*--- Algorith to use, default is late insertion. ---*/
+		bool eisch_algorithm;
+
+		/*--- Stores the ratio of the primary area to the total table size. ---*/
+		double addressFactor;
+
+		/*--- Slot to try next when a bucket spills. ---*/
+		size_t unoccupiedPos;
+
+		/*--- Array to store the Buckets. ---*/
+		vector< Bucket > array;
+};
+
+#endif
@@ -0,0 +1,361 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include "coalescedfilter.h"
+#include "hashingfunction.h"
+#include "primes.h"
+#include "exceptions.h"
+
+/*--- Fixed seed that spreads the bits of the hash over the address and the fingerprint. ---*/
+#define FILTER_SEED 0x9E3779B97F4A7C15ULL
+
+/*--- Constructor. ---*/
+template < class Object >
+coalesced_filter< Object >::coalesced_filter( size_t size, bool eisch, int fingerprintBits )
+	: eisch_algorithm( eisch ), slots( nextPrime( size ) ) {
+
+	/*--- The whole table is the address region. ---*/
+	addressFactor = -1.0;
+	addressSize = slots;
+
+	/*--- Between 1 and 16 bits. ---*/
+	this->fingerprintBits = ( fingerprintBits < 1 ) ? 1 : ( fingerprintBits > 16 ) ? 16 : fingerprintBits;
+
+	/*--- The link holds a position plus one. ---*/
+	linkBits = packed_bits::bitWidth( slots );
+	entryBits = linkBits + 1 + this->fingerprintBits;
+	entries.assign( slots * entryBits );
+
+	clear( );
+}
+
+/*--- Constructor. ---*/
+template < class Object >
+coalesced_filter< Object >::coalesced_filter( size_t size, bool eich, const double & addressFactor, int fingerprintBits )
+	: eisch_algorithm( eich ), slots( nextPrime( size ) ) {
+
+	/*--- Default in case is less than zero or greater than 1. ---*/
+	this->addressFactor = addressFactor;
+	if( ( this->addressFactor < 0.0 ) || ( this->addressFactor > 1.0 ) )
+		this->addressFactor = 0.86;
+
+	/*--- The rest of the table is the cellar. ---*/
+	addressSize = ( size_t )( this->addressFactor * slots );
+
+	/*--- Between 1 and 16 bits. ---*/
+	this->fingerprintBits = ( fingerprintBits < 1 ) ? 1 : ( fingerprintBits > 16 ) ? 16 : fingerprintBits;
+
+	/*--- The link holds a position plus one. ---*/
+	linkBits = packed_bits::bitWidth( slots );
+	entryBits = linkBits + 1 + this->fingerprintBits;
+	entries.assign( slots * entryBits );
+
+	clear( );
+}
+
+/*--- Insert the fingerprint of the object. ---*/
+template < class Object >
+void coalesced_filter< Object >::insert( const Object & object ) {
+
+	if( try_insert( object ).status == FULL ) /*--- No empty location left. ---*/
+		throw IsFullException( );
+}
+
+/* Insert the fingerprint of the object without throwing.
+ * Returns INSERTED or FULL together with the slot.
+*/
+template < class Object >
+InsertResult coalesced_filter< Object >::try_insert( const Object & object ) {
+
+	size_t home;
+	unsigned short print;
+	fingerprint( object, home, print );
+
+	InsertResult inserted = { INSERTED, home };
+
+	/*--- If there is nothing in the home address, the fingerprint starts its chain there. ---*/
+	if( linkOf( home ) == 0 ) {
+
+		store( home, print, true, home + 1 );
+
+		occupied++;
+		return inserted;
+	}
+
+	/* Find the bottommost empty location in the table.
+	 * If none is found, report a "full table".
+	*/
+	while( ( unoccupiedPos != END_OF_CHAIN ) && ( linkOf( unoccupiedPos ) != 0 ) )
+		unoccupiedPos--;
+
+	if( unoccupiedPos == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	size_t slot = unoccupiedPos;
+
+	/*--- A fingerprint displaced into the home address moves out of the way. ---*/
+	if( !isHome( home ) ) {
+
+		relocate( home, slot );
+		store( home, print, true, home + 1 );
+
+		occupied++;
+		return inserted;
+	}
+
+	if( !eisch_algorithm ) {
+
+		/*--- Find the end of the chain and link it there, it links back to the home address. ---*/
+		size_t last = home;
+		while( linkOf( last ) - 1 != home )
+			last = linkOf( last ) - 1;
+
+		store( slot, print, false, home + 1 );
+		setLink( last, slot + 1 );
+	}
+
+	else {
+
+		/*--- Link it right after the home address. ---*/
+		store( slot, print, false, linkOf( home ) );
+		setLink( home, slot + 1 );
+	}
+
+	occupied++;
+
+	inserted.pos = slot;
+	return inserted;
+}
+
+/* Removes one fingerprint of the object.  A fingerprint at its home
+ * address is replaced by the next one of its chain.
+*/
+template < class Object >
+bool coalesced_filter< Object >::remove( const Object & object ) {
+
+	size_t home;
+	unsigned short print;
+	fingerprint( object, home, print );
+
+	size_t prev;
+	SearchedResult result = findInProbeChain( home, print, prev );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return false;
+
+	if( result.pos != home ) {
+
+		/*--- Unlink the displaced fingerprint. ---*/
+		setLink( prev, linkOf( result.pos ) );
+		release( result.pos );
+	}
+
+	else if( linkOf( home ) - 1 != home ) {
+
+		/*--- The next fingerprint of the chain takes the home address. ---*/
+		size_t follower = linkOf( home ) - 1;
+		store( home, printOf( follower ), true, linkOf( follower ) );
+		release( follower );
+	}
+
+	else
+		release( home );
+
+	occupied--;
+	return true;
+}
+
+/*--- Returns true if the object may be stored, false if it certainly is not. ---*/
+template < class Object >
+bool coalesced_filter< Object >::contains( const Object & object ) const {
+
+	size_t home;
+	unsigned short print;
+	fingerprint( object, home, print );
+
+	size_t prev;
+	return findInProbeChain( home, print, prev ).probes > 0;
+}
+
+/* Returns the false positive rate expected at the current load, a
+ * lookup compares the fingerprints of its home address only.
+*/
+template < class Object >
+double coalesced_filter< Object >::expectedFalsePositiveRate( ) const {
+
+	return ( ( double )occupied / addressSize ) / ( double )( 1 << fingerprintBits );
+}
+
+/*--- Empty the filter logically. ---*/
+template < class Object >
+void coalesced_filter< Object >::clear( ) {
+
+	occupied = 0;
+
+	/*--- Table Size - 1. ---*/
+	unoccupiedPos = slots - 1;
+
+	entries.clear( );
+}
+
+/*--- Returns the number of fingerprints currently within the filter. ---*/
+template < class Object >
+size_t coalesced_filter< Object >::elements( ) const {
+
+	return occupied;
+}
+
+/*--- Returns the size of the filter. ---*/
+template < class Object >
+size_t coalesced_filter< Object >::size( ) const {
+
+	return slots;
+}
+
+/*--- Returns the number of bytes used by the slots of the filter. ---*/
+template < class Object >
+size_t coalesced_filter< Object >::memory( ) const {
+
+	return entries.memory( );
+}
+
+/*--- Computes the home address and the fingerprint of the object. ---*/
+template < class Object >
+void coalesced_filter< Object >::fingerprint( const Object & object, size_t & home, unsigned short & print ) const {
+
+	unsigned long long value = hash( object, FILTER_SEED );
+
+	/*--- The address from the whole hash, the fingerprint from its top bits. ---*/
+	home = ( size_t )( value % addressSize );
+	print = ( unsigned short )( value >> ( 64 - fingerprintBits ) );
+}
+
+/* Searches the fingerprint of the home address till the end of
+ * the probe chain.  prev is the slot before the one found.
+*/
+template < class Object >
+SearchedResult coalesced_filter< Object >::findInProbeChain( size_t home, unsigned short print, size_t & prev ) const {
+
+	SearchedResult result = { 0, END_OF_CHAIN, 1 };
+	prev = END_OF_CHAIN;
+
+	/*--- Only a fingerprint at its home address starts a chain. ---*/
+	if( !isHome( home ) )
+		return result;
+
+	size_t pos = home;
+	for( size_t visited = 1; ; visited++ ) {
+
+		/*--- Every fingerprint of the chain has the same home address. ---*/
+		if( printOf( pos ) == print ) {
+
+			result.probes = visited;
+			result.pos = pos;
+			result.length = visited;
+			return result;
+		}
+
+		result.length = visited;
+		prev = pos;
+
+		/*--- Stop once the chain links back to its home address. ---*/
+		pos = linkOf( pos ) - 1;
+		if( pos == home )
+			break;
+	}
+
+	/*--- Not found, the position is the last element within the probe chain. ---*/
+	result.pos = prev;
+	return result;
+}
+
+/* Moves the displaced fingerprint at the given slot to the empty
+ * slot to, linking the copy in before the slot is overwritten.
+*/
+template < class Object >
+void coalesced_filter< Object >::relocate( size_t pos, size_t to ) {
+
+	/*--- The home address of the fingerprint is where its chain links back to. ---*/
+	size_t home = linkOf( pos ) - 1;
+	while( !isHome( home ) )
+		home = linkOf( home ) - 1;
+
+	/*--- Find the fingerprint linking to it. ---*/
+	size_t before = home;
+	while( linkOf( before ) - 1 != pos )
+		before = linkOf( before ) - 1;
+
+	store( to, printOf( pos ), false, linkOf( pos ) );
+	setLink( before, to + 1 );
+}
+
+/*--- Marks the given slot empty and available to the insertions. ---*/
+template < class Object >
+void coalesced_filter< Object >::release( size_t pos ) {
+
+	store( pos, 0, false, 0 );
+
+	if( ( pos > unoccupiedPos ) || ( unoccupiedPos == END_OF_CHAIN ) )
+		unoccupiedPos = pos;
+}
+
+/*--- Returns the link of the given slot, the next position plus one, zero when it is empty. ---*/
+template < class Object >
+size_t coalesced_filter< Object >::linkOf( size_t pos ) const {
+
+	return ( size_t )entries.read( pos * entryBits, linkBits );
+}
+
+/*--- Returns true if the given slot holds a fingerprint at its home address. ---*/
+template < class Object >
+bool coalesced_filter< Object >::isHome( size_t pos ) const {
+
+	return entries.read( pos * entryBits + linkBits, 1 ) != 0;
+}
+
+/*--- Returns the fingerprint stored at the given slot. ---*/
+template < class Object >
+unsigned short coalesced_filter< Object >::printOf( size_t pos ) const {
+
+	return ( unsigned short )entries.read( pos * entryBits + linkBits + 1, fingerprintBits );
+}
+
+/*--- Writes every field of the given slot. ---*/
+template < class Object >
+void coalesced_filter< Object >::store( size_t pos, unsigned short print, bool home, size_t link ) {
+
+	entries.write( pos * entryBits, linkBits, link );
+	entries.write( pos * entryBits + linkBits, 1, home ? 1 : 0 );
+	entries.write( pos * entryBits + linkBits + 1, fingerprintBits, print );
+}
+
+/*--- Writes the link of the given slot. ---*/
+template < class Object >
+void coalesced_filter< Object >::setLink( size_t pos, size_t link ) {
+
+	entries.write( pos * entryBits, linkBits, link );
+}
@@ -0,0 +1,163 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __COALESCED_FILTER_H__
+#define __COALESCED_FILTER_H__
+
+#include "coalescedhashing.h"
+#include "packedbits.h"
+
+/**
+ * An approximate membership filter which stores short fingerprints in
+ * the slots of a coalesced hashing table.
+ *
+ * => The hash of an object gives its home address and a fingerprint of
+ *    up to 16 bits.  A slot packs the fingerprint in fingerprintBits,
+ *    a home flag and a link just wide enough for the size of the
+ *    filter, so it takes 23 bits for 8-bit fingerprints in a filter of
+ *    13093 slots.
+ *
+ * => The home flag marks a fingerprint stored at its home address,
+ *    which heads the chain of the other fingerprints of that address.
+ *    The last of them links back to it.  A fingerprint found at the
+ *    home address of a new one was displaced there by another chain,
+ *    and is moved to an empty slot first, so a lookup only compares
+ *    fingerprints of its own home address.  Colliding fingerprints go
+ *    to the cellar first, early or late as in coalesced_hashing.
+ *
+ * => contains( ) never misses an inserted object, and reports an object
+ *    that was not inserted with a probability close to the number of
+ *    records per home address divided by 2^fingerprintBits.
+ *
+ * => Inserting an object twice stores two fingerprints, and remove( )
+ *    takes one out, so only objects that were inserted may be removed.
+*/
+
+template < class Object >
+class coalesced_filter {
+
+	public:
+
+		/*--- Constructor. ---*/
+		coalesced_filter( size_t size, bool eisch, int fingerprintBits = 16 );
+
+		/*--- Constructor. ---*/
+		coalesced_filter( size_t size, bool eich, const double & addressFactor, int fingerprintBits = 16 );
+
+		/*--- Insert the fingerprint of the object. ---*/
+		void insert( const Object & object );
+
+		/* Insert the fingerprint of the object without throwing.
+		 * Returns INSERTED or FULL together with the slot.
+		*/
+		InsertResult try_insert( const Object & object );
+
+		/* Removes one fingerprint of the object.
+		 * Returns false when none is stored.
+		*/
+		bool remove( const Object & object );
+
+		/*--- Returns true if the object may be stored, false if it certainly is not. ---*/
+		bool contains( const Object & object ) const;
+
+		/*--- Returns the false positive rate expected at the current load. ---*/
+		double expectedFalsePositiveRate( ) const;
+
+		/*--- Empty the filter logically. ---*/
+		void clear( );
+
+		/*--- Returns the number of fingerprints currently within the filter. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the size of the filter. ---*/
+		size_t size( ) const;
+
+		/*--- Returns the number of bytes used by the slots of the filter. ---*/
+		size_t memory( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Computes the home address and the fingerprint of the object. ---*/
+		void fingerprint( const Object & object, size_t & home, unsigned short & print ) const;
+
+		/* Searches the fingerprint of the home address till the end of
+		 * the probe chain.  prev is the slot before the one found.
+		*/
+		SearchedResult findInProbeChain( size_t home, unsigned short print, size_t & prev ) const;
+
+		/* Moves the displaced fingerprint at the given slot to the empty
+		 * slot to, linking the copy in before the slot is overwritten.
+		*/
+		void relocate( size_t pos, size_t to );
+
+		/*--- Marks the given slot empty and available to the insertions. ---*/
+		void release( size_t pos );
+
+		/*--- Returns the link of the given slot, the next position plus one, zero when it is empty. ---*/
+		size_t linkOf( size_t pos ) const;
+
+		/*--- Returns true if the given slot holds a fingerprint at its home address. ---*/
+		bool isHome( size_t pos ) const;
+
+		/*--- Returns the fingerprint stored at the given slot. ---*/
+		unsigned short printOf( size_t pos ) const;
+
+		/*--- Writes every field of the given slot. ---*/
+		void store( size_t pos, unsigned short print, bool home, size_t link );
+
+		/*--- Writes the link of the given slot. ---*/
+		void setLink( size_t pos, size_t link );
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- Stores the number of fingerprints currently stored. ---*/
+		size_t occupied;
+
+		/*--- Algorith to use, default is late insertion. ---*/
+		bool eisch_algorithm;
+
+		/*--- Stores the ratio of the primary area to the total table size. ---*/
+		double addressFactor;
+
+		/*--- Number of slots of the filter. ---*/
+		size_t slots;
+
+		/*--- Number of slots that can be a home address. ---*/
+		size_t addressSize;
+
+		/*--- Number of bits kept from the hash for each fingerprint. ---*/
+		int fingerprintBits;
+
+		/*--- Width of the link and of a whole slot, in bits. ---*/
+		size_t linkBits, entryBits;
+
+		/*--- position to insert the incoming item during insertion. ---*/
+		size_t unoccupiedPos;
+
+		/*--- Stores the slots, packed one after the other. ---*/
+		packed_bits entries;
+};
+
+#endif
@@ -24,10 +24,28 @@
 */
 
 #include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
 #include "coalescedhashing.h"
+#include "coalescedsnapshot.h"
 #include "hashingfunction.h"
+#include "primes.h"
 #include "exceptions.h"
 
+/*--- Hint to load the cache line of the given address. ---*/
+#if defined( __GNUC__ )
+#define PREFETCH( address ) __builtin_prefetch( address )
+#elif defined( _M_X64 ) || defined( _M_IX86 )
+#include <xmmintrin.h>
+#define PREFETCH( address ) _mm_prefetch( ( const char * )( address ), _MM_HINT_T0 )
+#else
+#define PREFETCH( address )
+#endif
+
+/*--- Number of objects whose home slot is prefetched ahead by the batched functions. ---*/
+#define PREFETCH_DISTANCE 8
+
 /**
  * A data structure which implements coalesced hashing as collision
  * resolution method for the hash table.
@@ -45,13 +63,42 @@
 */
 
 /*--- Constructor. ---*/
-template < class Object >
-coalesced_hashing< Object >::coalesced_hashing( int size, bool eisch )
+template < class Object, class Link >
+coalesced_hashing< Object, Link >::coalesced_hashing( size_t size, bool eisch )
 	: array( nextPrime( size ) ), eisch_algorithm( eisch ) {
 
+	/*--- The largest link value marks the end of a chain. ---*/
+	if( array.size( ) >= ( size_t )( Link ) -1 )
+		throw IsFullException( );
+
 	/*--- Default address factor. ---*/
 	addressFactor = -1.0;
 
+	/*--- The whole table is the address region. ---*/
+	addressSize = array.size( );
+	frozen = false;
+
+	/*--- The identity hash is used until the flooding defense is enabled. ---*/
+	seeded = false;
+	seed = 0;
+	maxChainLength = 0;
+	insertsSinceRehash = 0;
+	rehashCount = 0;
+
+	/*--- A single cellar until local cellars are enabled. ---*/
+	groupSlots = 0;
+	groupHomes = 0;
+
+	/*--- Insertions fail on a full table until cache mode is enabled. ---*/
+	cacheMode = false;
+	clockHand = 0;
+	ttl = 0;
+	statistics.hits = statistics.misses = statistics.evictions = statistics.expirations = 0;
+
+	/*--- Defragmentation starts at the first home address. ---*/
+	defragCursor = 0;
+	defragClean = 0;
+
 	/*--- Table Size - 1. ---*/
 	unoccupiedPos = array.size() - 1;
 
@@ -60,10 +107,14 @@ coalesced_hashing< Object >::coalesced_hashing( int size, bool eisch )
 }
 
 /*--- Constructor. ---*/
-template < class Object >
-coalesced_hashing< Object >::coalesced_hashing( int size, bool eich, const double & addressFactor)
+template < class Object, class Link >
+coalesced_hashing< Object, Link >::coalesced_hashing( size_t size, bool eich, const double & addressFactor)
 	: array( nextPrime( size ) ), eisch_algorithm( eich ) {
 
+	/*--- The largest link value marks the end of a chain. ---*/
+	if( array.size( ) >= ( size_t )( Link ) -1 )
+		throw IsFullException( );
+
 	/*--- Set address factor. ---*/
 	this->addressFactor = addressFactor;
 
@@ -71,6 +122,31 @@ coalesced_hashing< Object >::coalesced_hashing( int size, bool eich, const doubl
 	if( ( this->addressFactor < 0.0 ) || ( this->addressFactor > 1.0 ) )
 		this->addressFactor = 0.86;
 
+	/*--- The rest of the table is the cellar. ---*/
+	addressSize = ( size_t )( this->addressFactor * array.size( ) );
+	frozen = false;
+
+	/*--- The identity hash is used until the flooding defense is enabled. ---*/
+	seeded = false;
+	seed = 0;
+	maxChainLength = 0;
+	insertsSinceRehash = 0;
+	rehashCount = 0;
+
+	/*--- A single cellar until local cellars are enabled. ---*/
+	groupSlots = 0;
+	groupHomes = 0;
+
+	/*--- Insertions fail on a full table until cache mode is enabled. ---*/
+	cacheMode = false;
+	clockHand = 0;
+	ttl = 0;
+	statistics.hits = statistics.misses = statistics.evictions = statistics.expirations = 0;
+
+	/*--- Defragmentation starts at the first home address. ---*/
+	defragCursor = 0;
+	defragClean = 0;
+
 	/*--- Table Size - 1. ---*/
 	unoccupiedPos = array.size( ) - 1;
 
@@ -79,204 +155,1279 @@ coalesced_hashing< Object >::coalesced_hashing( int size, bool eich, const doubl
 }
 
 /*--- Insert into the table. ---*/
-template < class Object >
-void coalesced_hashing< Object >::insert( const Object& object ) {
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::insert( const Object& object ) {
 
-	/*--- Get the position to insert the object. ---*/
-	int pos = findPos( object );
+	/*--- Try to insert the item. ---*/
+	InsertResult result = try_insert( object );
+
+	if( result.status == DUPLICATE ) /*--- Already stored. ---*/
+		throw DuplicateItemException( );
+
+	else if( result.status == FULL ) /*--- No empty location left. ---*/
+		throw IsFullException( );
+
+	else if( result.status == FROZEN ) /*--- Read-only after freeze( ). ---*/
+		throw IsFrozenException( );
+}
+
+/* Insert into the table without throwing.
+ * Returns the status together with the slot of the object.
+*/
+template < class Object, class Link >
+InsertResult coalesced_hashing< Object, Link >::try_insert( const Object & object ) {
+
+	/*--- A frozen table is read-only. ---*/
+	if( frozen ) {
+
+		InsertResult readOnly = { FROZEN, END_OF_CHAIN };
+		return readOnly;
+	}
+
+	/*--- Insert from the home address of the object. ---*/
+	return insertFromHome( object, findPos( object ), NULL );
+}
+
+/* Searches the object from its home address and inserts it when
+ * missing, or merges it into the stored one when a merge is given.
+*/
+template < class Object, class Link >
+InsertResult coalesced_hashing< Object, Link >::insertFromHome( const Object & object, size_t pos, MergeFunction merge ) {
 
 	/* Search in the probe chain for the given object
 	 * starting at the home address.
 	*/
-	SearchedResult result = findInProbeChain(object, pos);
-	if( result.probes > 0 ) /*--- Not found. ---*/
-		throw DuplicateItemException( );
+	SearchedResult result = findInProbeChain( object, pos );
+	if( result.probes > 0 ) { /*--- Already stored. ---*/
+
+		/*--- Merge in place, the record keeps its slot and its links. ---*/
+		if( merge != NULL ) {
+
+			merge( array.write( result.pos ).object, object );
+
+			/*--- A merged record lives for another TTL. ---*/
+			if( cacheMode && ( ttl > 0 ) )
+				expiries[ result.pos ] = expiryFromNow( );
+		}
+
+		InsertResult duplicate = { DUPLICATE, result.pos };
+		return duplicate;
+	}
+
+	/*--- A frozen table is read-only. ---*/
+	if( frozen ) {
+
+		InsertResult readOnly = { FROZEN, END_OF_CHAIN };
+		return readOnly;
+	}
+
+	/*--- An expired copy of the object is reused in place, it is already on the chain. ---*/
+	if( cacheMode && ( ttl > 0 ) ) {
+
+		size_t stale = findExpired( object, pos );
+		if( stale != END_OF_CHAIN ) {
+
+			array.write( stale ).object = object;
+			setCacheState( stale, 1, expiryFromNow( ) );
+			statistics.expirations++;
+
+			InsertResult renewed = { INSERTED, stale };
+			return renewed;
+		}
+	}
+
+	/*--- Insert at the end of the chain that was just walked. ---*/
+	InsertResult inserted = insertAfterSearch( object, pos, result );
+
+	/* A full cache makes room by evicting a record, which may change
+	 * the chain of the object, so it is searched again.
+	*/
+	if( cacheMode ) {
+
+		if( inserted.status == FULL ) {
+
+			evict( );
+			result = findInProbeChain( object, pos );
+			inserted = insertAfterSearch( object, pos, result );
+		}
+
+		if( inserted.status == INSERTED )
+			setCacheState( inserted.pos, 1, expiryFromNow( ) );
+	}
+
+	/*--- Watch the length of the chains when defending against flooding. ---*/
+	if( ( inserted.status == INSERTED ) && ( maxChainLength > 0 ) ) {
 
-	else { /*--- Try to insert the item. ---*/
+		insertsSinceRehash++;
 
-		/*--- If there is nothing in the home address. ---*/
-		if( result.pos == -1 ) {
+		/* A long chain with a secret seed is unlikely, rehash with a
+		 * new seed, but not before a quarter of the records were
+		 * inserted since the last rehash.
+		*/
+		if( ( result.length >= maxChainLength ) && ( insertsSinceRehash >= occupied / 4 ) ) {
 
-			/*--- Insert item. ---*/
-			array[ pos ] = CoalescedHashingEntry( object, -1, ACTIVE );
+			rehash( );
 
-			/*--- Increase occupied variable. ---*/
-			occupied++;
+			/*--- The object moved. ---*/
+			inserted.pos = findInProbeChain( object, findPos( object ) ).pos;
 		}
+	}
+
+	return inserted;
+}
+
+/* Returns the stored object equal to the given one, inserting
+ * it first when missing.  The chain is walked only once.
+ * Returns NULL when the object is missing and the table is full.
+*/
+template < class Object, class Link >
+const Object * coalesced_hashing< Object, Link >::insert_or_find( const Object & object ) {
+
+	InsertResult result = try_insert( object );
+
+	if( ( result.status == FULL ) || ( result.status == FROZEN ) )
+		return NULL;
+
+	return &array[ result.pos ].object;
+}
+
+/* Merges the object into the stored object equal to it, or inserts
+ * it as the initial value when missing, walking the chain once.
+*/
+template < class Object, class Link >
+InsertResult coalesced_hashing< Object, Link >::upsert( const Object & object, MergeFunction merge ) {
+
+	return insertFromHome( object, findPos( object ), merge );
+}
+
+/* Upserts the given objects in order.  The home slots of the
+ * objects ahead are prefetched while the current one is merged.
+ * Returns the number of objects applied.
+*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::upsert( const Object * objects, size_t count, MergeFunction merge ) {
+
+	/*--- Home slots of the objects ahead, indexed modulo the distance. ---*/
+	size_t homes[ PREFETCH_DISTANCE ];
+	for( size_t i = 0; ( i < PREFETCH_DISTANCE ) && ( i < count ); i++ ) {
+
+		homes[ i ] = findPos( objects[ i ] );
+		PREFETCH( &array[ homes[ i ] ] );
+	}
+
+	for( size_t i = 0; i < count; i++ ) {
+
+		size_t rehashed = rehashCount;
+		InsertResult result = insertFromHome( objects[ i ], homes[ i % PREFETCH_DISTANCE ], merge );
+
+		if( ( result.status == FULL ) || ( result.status == FROZEN ) )
+			return i;
+
+		/*--- A rehash drew a new seed, the homes ahead moved. ---*/
+		if( rehashed != rehashCount )
+			for( size_t j = i + 1; ( j < i + PREFETCH_DISTANCE ) && ( j < count ); j++ )
+				homes[ j % PREFETCH_DISTANCE ] = findPos( objects[ j ] );
+
+		/*--- Reuse the slot of the current object for the one that is the distance ahead. ---*/
+		if( i + PREFETCH_DISTANCE < count ) {
+
+			size_t ahead = findPos( objects[ i + PREFETCH_DISTANCE ] );
+			homes[ i % PREFETCH_DISTANCE ] = ahead;
+			PREFETCH( &array[ ahead ] );
+		}
+	}
+
+	return count;
+}
+
+/*--- Returns true if the item is stored in the table. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::contains( const Object & object ) const {
 
-		else { /*--- Lets go to the end of the probe chain. ---*/
+	return lookup( object, findPos( object ) ).probes > 0;
+}
+
+/* Looks up the given objects in order, prefetching the home
+ * slots of the objects ahead.  Returns the number of objects found.
+*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::contains( const Object * objects, size_t count, bool * found ) const {
 
-			/* Find the bottommost empty location in the table.
-			 * If none is found, terminate with a "full table"
-			 * message.
-			*/
-			if( unoccupiedPos < 0 )
-				throw IsFullException( );
+	/*--- Home slots of the objects ahead, indexed modulo the distance. ---*/
+	size_t homes[ PREFETCH_DISTANCE ];
+	for( size_t i = 0; ( i < PREFETCH_DISTANCE ) && ( i < count ); i++ ) {
 
-			else {
+		homes[ i ] = findPos( objects[ i ] );
+		PREFETCH( &array[ homes[ i ] ] );
+	}
 
-				/*--- Insert item into the unoccupied location ---*/
-				do {
+	size_t hits = 0;
+	for( size_t i = 0; i < count; i++ ) {
 
-					/*--- If the position is emtpy, break. ---*/
-					if( array[ unoccupiedPos ].status != ACTIVE )
-						break;
+		found[ i ] = lookup( objects[ i ], homes[ i % PREFETCH_DISTANCE ] ).probes > 0;
+		if( found[ i ] )
+			hits++;
 
-					/*--- Else, decrement the value. ---*/
-					unoccupiedPos--;
+		if( i + PREFETCH_DISTANCE < count ) {
 
-					/*--- Do, while the unoccupied index is greater than zero. ---*/
-				} while( unoccupiedPos > -1 );
+			size_t ahead = findPos( objects[ i + PREFETCH_DISTANCE ] );
+			homes[ i % PREFETCH_DISTANCE ] = ahead;
+			PREFETCH( &array[ ahead ] );
+		}
+	}
 
-				/*--- If the unoccupied index is -1, then the table is full. ---*/
-				if( unoccupiedPos < 0 )
-					throw IsFullException( );
+	return hits;
+}
 
-				else {
+/* Find an item from the table without throwing.
+ * Returns NULL when the item is not stored.
+*/
+template < class Object, class Link >
+const Object * coalesced_hashing< Object, Link >::try_find( const Object & object ) const {
 
-					/*--- Else, insert the item. ---*/
-					array[ unoccupiedPos ] = CoalescedHashingEntry( object, -1, ACTIVE );
+	SearchedResult result = lookup( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return NULL;
+
+	return &array[ result.pos ].object;
+}
+
+#if defined( __cpp_impl_coroutine )
+/* Finds an item from within a lookup_task, co_await table.async_find( object )
+ * gives what find( ) would.
+*/
+template < class Object, class Link >
+typename coalesced_hashing< Object, Link >::find_awaiter coalesced_hashing< Object, Link >::async_find( const Object & object ) const {
+
+	return find_awaiter( this, object );
+}
 
-					/* Set the link field of the record at the end of the
-					 * chain to point to the location of the newly inserted record.
-					*/
-					if (!eisch_algorithm)
-						array[ result.pos ].linkpos = unoccupiedPos;
+/*--- Prefetches the home slot of the object. ---*/
+template < class Object, class Link >
+coalesced_hashing< Object, Link >::find_awaiter::find_awaiter( const coalesced_hashing * table, const Object & object )
+	: table( table ), object( object ), probes( 0 ), found( false ) {
 
-					else {
+	pos = table->findPos( object );
+	PREFETCH( &table->array[ pos ] );
+}
+
+/*--- Never ready, the home slot is read on the next turn. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::find_awaiter::await_ready( ) const {
+
+	return false;
+}
+
+/*--- Hands the lookup to the scheduler of the request. ---*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::find_awaiter::await_suspend( lookup_task::handle_type handle ) {
+
+	waiting = handle;
+	handle.promise( ).scheduler->suspend( this );
+}
+
+/*--- Returns the object found, as find( ) does. ---*/
+template < class Object, class Link >
+const_ref< Object > coalesced_hashing< Object, Link >::find_awaiter::await_resume( ) const {
+
+	if( !found )
+		return const_ref< Object >( );
+
+	return const_ref< Object >( table->array[ pos ].object, table->array[ pos ].next( ), probes );
+}
+
+/* Looks at the current slot, as findInProbeChain( ) does, and
+ * prefetches the next one.  Returns true once the lookup is over.
+*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::find_awaiter::step( ) {
 
-						/* Create a temporary to store the link
-						 * of where the home address is pointing to.
-						*/
-						size_t temppos = array[ pos ].linkpos;
+	probes++;
 
-						/*--- Assign the new link position. ---*/
-						array[ pos ].linkpos = unoccupiedPos;
+	const CoalescedHashingEntry & entry = table->array[ pos ];
+	if( ( entry.status == ACTIVE ) && ( object == entry.object ) && !table->isExpired( pos ) ) {
 
-						/* Now from the inserted item, assign the
-						 * link where the home address used to point
-						 * before.
-						*/
-						array[ unoccupiedPos ].linkpos = temppos;
-					}
+		if( table->cacheMode ) {
 
-					/*--- Increase occupied variable. ---*/
-					occupied++;
-				}
+			table->referenced[ pos ] = 1;
+			table->statistics.hits++;
+		}
+
+		found = true;
+		return true;
+	}
+
+	/*--- End of the probe chain, the object is not stored. ---*/
+	if( entry.next( ) == END_OF_CHAIN ) {
+
+		if( table->cacheMode )
+			table->statistics.misses++;
+
+		return true;
+	}
+
+	pos = entry.next( );
+	PREFETCH( &table->array[ pos ] );
+	return false;
+}
+#endif
+
+/*--- Returns the object stored at the given slot. ---*/
+template < class Object, class Link >
+const Object & coalesced_hashing< Object, Link >::objectAt( size_t pos ) const {
+
+	return array[ pos ].object;
+}
+
+/*--- Returns true if the given slot holds an object. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::isOccupied( size_t pos ) const {
+
+	return array[ pos ].status == ACTIVE;
+}
+
+/* Inserts the object once its probe chain has been searched
+ * and the object was not found in it.
+*/
+template < class Object, class Link >
+InsertResult coalesced_hashing< Object, Link >::insertAfterSearch( const Object & object, size_t pos, const SearchedResult & result ) {
+
+	InsertResult inserted = { INSERTED, pos };
+
+	/*--- The chains changed, the next defragmentation visits every home address again. ---*/
+	defragClean = 0;
+
+	/*--- If there is nothing in the home address. ---*/
+	if( result.pos == END_OF_CHAIN ) {
+
+		/*--- Insert item. ---*/
+		array.write( pos ) = CoalescedHashingEntry( object, END_OF_CHAIN, ACTIVE );
+
+		/*--- Increase occupied variable. ---*/
+		occupied++;
+		return inserted;
+	}
+
+	/* Find the bottommost empty location for the record.
+	 * If none is found, report a "full table".
+	*/
+	size_t slot = emptySlot( pos );
+	if( slot == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	/*--- Else, insert the item. ---*/
+	array.write( slot ) = CoalescedHashingEntry( object, END_OF_CHAIN, ACTIVE );
+
+	/* Set the link field of the record at the end of the
+	 * chain to point to the location of the newly inserted record.
+	*/
+	if( !eisch_algorithm )
+		array.write( result.pos ).linkpos = ( Link )slot;
+
+	else {
+
+		/* Now from the inserted item, assign the
+		 * link where the home address used to point
+		 * before.
+		*/
+		array.write( slot ).linkpos = array[ pos ].linkpos;
+
+		/*--- Assign the new link position. ---*/
+		array.write( pos ).linkpos = ( Link )slot;
+	}
+
+	/*--- Increase occupied variable. ---*/
+	occupied++;
+
+	inserted.pos = slot;
+	return inserted;
+}
+
+/*--- Returns the bottommost empty slot for a record colliding at pos, or END_OF_CHAIN. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::emptySlot( size_t pos ) {
+
+	/*--- Look in the group of the home address first. ---*/
+	if( groupSlots > 0 ) {
+
+		size_t group = pos / groupSlots;
+		size_t first = group * groupSlots;
+		size_t & cursor = groupCursors[ group ];
+
+		while( ( cursor > first ) && ( array[ cursor - 1 ].status == ACTIVE ) )
+			cursor--;
+
+		if( cursor > first )
+			return cursor - 1;
+	}
+
+	/*--- Find the bottommost empty location in the table. ---*/
+	while( ( unoccupiedPos != END_OF_CHAIN ) && ( array[ unoccupiedPos ].status == ACTIVE ) )
+		unoccupiedPos--;
+
+	if( unoccupiedPos != END_OF_CHAIN )
+		return unoccupiedPos;
+
+	/*--- Then a slot freed by a removal, unless it was taken back as a home address. ---*/
+	while( !freeSlots.empty( ) ) {
+
+		size_t slot = freeSlots.back( );
+		freeSlots.pop_back( );
+
+		if( array[ slot ].status != ACTIVE )
+			return slot;
+	}
+
+	return END_OF_CHAIN;
+}
+
+/* Rewrites the table into a read-only layout where every chain
+ * only holds the records of its own home address.  The first
+ * record of a home address stays at the home address, the rest of
+ * them take the free slots nearest after it, the empty home
+ * addresses first and then the cellar, so a run usually shares the
+ * cache line or the page of its home slot.  The table keeps its size.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::freeze( ) {
+
+	if( frozen )
+		return;
+
+	/*--- Collect the records of every home address in chain order. ---*/
+	vector< size_t > members;
+	vector< size_t > runs( addressSize + 1, 0 );
+	for( size_t address = 0; address < addressSize; address++ ) {
+
+		size_t home = homeSlot( address );
+		runs[ address ] = members.size( );
+
+		for( size_t pos = home; pos != END_OF_CHAIN; pos = array[ pos ].next( ) ) {
+
+			/*--- Stop at an empty home address. ---*/
+			if( array[ pos ].status != ACTIVE )
+				break;
+
+			if( findPos( array[ pos ].object ) == home )
+				members.push_back( pos );
+		}
+	}
+	runs[ addressSize ] = members.size( );
+
+	/* Slots not taken by a first record, found with a disjoint set:
+	 * vacant[ slot ] leads to the first vacant slot at or after it, and
+	 * the extra last entry stands for the end of the table.
+	*/
+	vector< size_t > vacant( array.size( ) + 1 );
+	for( size_t slot = 0; slot <= array.size( ); slot++ )
+		vacant[ slot ] = slot;
+
+	for( size_t address = 0; address < addressSize; address++ )
+		if( runs[ address + 1 ] > runs[ address ] )
+			vacant[ homeSlot( address ) ] = homeSlot( address ) + 1;
+
+	/*--- Build the new layout, of the same size. ---*/
+	slot_pages< CoalescedHashingEntry > relayout( array.size( ) );
+
+	/*--- The reference bits and expiries follow the records in cache mode. ---*/
+	vector< unsigned char > frozenReferences( cacheMode ? array.size( ) : 0 );
+	vector< long long > frozenExpiries( ( ttl > 0 ) ? array.size( ) : 0 );
+
+	for( size_t address = 0; address < addressSize; address++ ) {
+
+		size_t first = runs[ address ];
+		size_t last = runs[ address + 1 ];
+
+		size_t pos = homeSlot( address );
+		for( size_t i = first; i < last; i++ ) {
+
+			/*--- The first record stays at the home address, the next takes the nearest vacant slot. ---*/
+			size_t next = END_OF_CHAIN;
+			if( i + 1 < last ) {
+
+				next = freeSlotAfter( vacant, pos );
+				vacant[ next ] = next + 1;
 			}
+
+			relayout.write( pos ) = CoalescedHashingEntry( array[ members[ i ] ].object, next, ACTIVE );
+
+			if( cacheMode ) {
+
+				frozenReferences[ pos ] = referenced[ members[ i ] ];
+				if( ttl > 0 )
+					frozenExpiries[ pos ] = expiries[ members[ i ] ];
+			}
+
+			pos = next;
 		}
 	}
+
+	/*--- Swap in the new layout. ---*/
+	array.swap( relayout );
+	referenced.swap( frozenReferences );
+	expiries.swap( frozenExpiries );
+	unoccupiedPos = END_OF_CHAIN;
+	freeSlots.clear( );
+	frozen = true;
 }
 
-/* Removes the item from the table.
- * This function is not currently implemented
- * at this time.
+/* Returns the first vacant slot after the given one, wrapping around
+ * at the end of the table, and shortens the paths it followed.
 */
-template < class Object >
-int coalesced_hashing< Object >::remove( const Object& object ) {
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::freeSlotAfter( vector< size_t > & vacant, size_t pos ) {
+
+	for( size_t start = pos + 1; ; start = 0 ) {
+
+		size_t slot = start;
+		while( vacant[ slot ] != slot )
+			slot = vacant[ slot ];
+
+		/*--- Point the path straight at the vacant slot. ---*/
+		for( size_t step = start; vacant[ step ] != slot; ) {
 
-	return -1;
+			size_t following = vacant[ step ];
+			vacant[ step ] = slot;
+			step = following;
+		}
+
+		/*--- The extra last entry means no vacant slot up to the end. ---*/
+		if( slot < vacant.size( ) - 1 )
+			return slot;
+	}
+}
+
+/*--- Returns true if the table was frozen. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::isFrozen( ) const {
+
+	return frozen;
+}
+
+/* Returns a read-only view of the table as it is now, sharing
+ * the slots with the table a page at a time.
+*/
+template < class Object, class Link >
+coalesced_snapshot< Object, Link > coalesced_hashing< Object, Link >::snapshot( ) const {
+
+	return coalesced_snapshot< Object, Link >( *this );
+}
+
+/* Removes the item from the table.  The records that follow it
+ * in its chain are inserted again, so no chain is left broken.
+ * Returns 1 when removed, 0 when not stored and -1 when frozen.
+*/
+template < class Object, class Link >
+int coalesced_hashing< Object, Link >::remove( const Object& object ) {
+
+	/*--- A frozen table is read-only. ---*/
+	if( frozen )
+		return -1;
+
+	SearchedResult result = findInProbeChain( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return 0;
+
+	unlink( result.pos );
+	return 1;
+}
+
+/*--- Returns the slot linking to the given slot, or END_OF_CHAIN. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::predecessor( size_t pos ) const {
+
+	/* A record is only ever linked from the chain of its home address,
+	 * and a record stored at its home address was never linked to.
+	*/
+	size_t home = findPos( array[ pos ].object );
+	if( home == pos )
+		return END_OF_CHAIN;
+
+	for( size_t prev = home; prev != END_OF_CHAIN; prev = array[ prev ].next( ) )
+		if( array[ prev ].next( ) == pos )
+			return prev;
+
+	return END_OF_CHAIN;
+}
+
+/* Takes the record at the given slot out of its chain and
+ * inserts the records that followed it again.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::unlink( size_t pos ) {
+
+	defragClean = 0;
+
+	/*--- Cut the chain before the record. ---*/
+	size_t prev = predecessor( pos );
+	if( prev != END_OF_CHAIN )
+		array.write( prev ).linkpos = ( Link )END_OF_CHAIN;
+
+	/*--- Take out the record and the rest of its chain. ---*/
+	vector< size_t > tail;
+	for( size_t next = array[ pos ].next( ); next != END_OF_CHAIN; next = array[ next ].next( ) )
+		tail.push_back( next );
+
+	vector< Object > records;
+	vector< unsigned char > references;
+	vector< long long > expiry;
+	for( size_t i = 0; i < tail.size( ); i++ ) {
+
+		records.push_back( array[ tail[ i ] ].object );
+		if( cacheMode ) {
+
+			references.push_back( referenced[ tail[ i ] ] );
+			expiry.push_back( ( ttl > 0 ) ? expiries[ tail[ i ] ] : 0 );
+		}
+	}
+
+	release( pos );
+	for( size_t i = 0; i < tail.size( ); i++ )
+		release( tail[ i ] );
+
+	occupied -= tail.size( ) + 1;
+
+	/*--- Insert the rest of the chain again, they fit in the slots just freed. ---*/
+	for( size_t i = 0; i < records.size( ); i++ ) {
+
+		size_t home = findPos( records[ i ] );
+		InsertResult inserted = insertAfterSearch( records[ i ], home, findInProbeChain( records[ i ], home ) );
+
+		if( cacheMode )
+			setCacheState( inserted.pos, references[ i ], expiry[ i ] );
+	}
+}
+
+/*--- Returns the number of chains, how many are merged, and the mean probes. ---*/
+template < class Object, class Link >
+ChainStatistics coalesced_hashing< Object, Link >::chainStatistics( ) const {
+
+	ChainStatistics chains = { 0, 0, 0, 0.0 };
+
+	/*--- Position of every slot within its list. ---*/
+	vector< size_t > depth( array.size( ), 0 );
+	double totalProbes = 0;
+	size_t records = 0;
+
+	/* A list starts at a record stored at its home address, the only
+	 * records nothing links to.
+	*/
+	for( size_t head = 0; head < array.size( ); head++ ) {
+
+		if( ( array[ head ].status != ACTIVE ) || ( findPos( array[ head ].object ) != head ) )
+			continue;
+
+		bool merged = false;
+		size_t length = 0;
+		for( size_t pos = head; pos != END_OF_CHAIN; pos = array[ pos ].next( ), length++ ) {
+
+			depth[ pos ] = length;
+
+			/*--- The home address of a record is earlier in its list. ---*/
+			size_t home = findPos( array[ pos ].object );
+			totalProbes += depth[ pos ] - depth[ home ] + 1;
+
+			if( home != head )
+				merged = true;
+		}
+
+		chains.chains++;
+		if( merged )
+			chains.mergedChains++;
+
+		if( length > chains.longestChain )
+			chains.longestChain = length;
+
+		records += length;
+	}
+
+	chains.meanProbes = ( records > 0 ) ? totalProbes / records : 0.0;
+	return chains;
+}
+
+/* Undoes coalescence a little at a time, rebuilding the merged lists
+ * met from where the last call stopped.  Returns the work done.
+*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::defragment( size_t budget ) {
+
+	if( frozen || ( occupied == 0 ) )
+		return 0;
+
+	/*--- Local cellars may have shrunk the address region. ---*/
+	if( defragCursor >= addressSize )
+		defragCursor = 0;
+
+	size_t work = 0;
+	while( ( work < budget ) && ( defragClean < addressSize ) ) {
+
+		size_t head = homeSlot( defragCursor );
+		defragCursor = ( defragCursor + 1 < addressSize ) ? defragCursor + 1 : 0;
+		defragClean++;
+		work++;
+
+		/*--- Only a record at its home address heads a list. ---*/
+		if( ( array[ head ].status != ACTIVE ) || ( findPos( array[ head ].object ) != head ) )
+			continue;
+
+		bool merged = false;
+		for( size_t pos = head; pos != END_OF_CHAIN; pos = array[ pos ].next( ), work++ )
+			if( findPos( array[ pos ].object ) != head )
+				merged = true;
+
+		if( merged )
+			work += separate( head );
+	}
+
+	return work;
+}
+
+/*--- Defragments for about the given number of seconds, returns the work done. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::defragmentFor( double seconds ) {
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now( ) +
+		std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< double >( seconds ) );
+
+	/*--- Small steps, so that the clock is read often enough. ---*/
+	const size_t step = 1024;
+	size_t work = 0;
+	while( std::chrono::steady_clock::now( ) < end ) {
+
+		size_t done = defragment( step );
+		work += done;
+
+		if( done < step )
+			break;
+	}
+
+	return work;
+}
+
+/* Rebuilds the list headed at the given slot so that every home
+ * address in it heads its own chain.  The home addresses met in the
+ * list are moved out one at a time, so every record stays reachable
+ * from its home address after each write.  Returns the work done.
+*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::separate( size_t head ) {
+
+	size_t work = 0;
+	for( ; ; ) {
+
+		/*--- The slots of the list, and the other home addresses of its records. ---*/
+		vector< size_t > slots, homes;
+		for( size_t pos = array[ head ].next( ); pos != END_OF_CHAIN; pos = array[ pos ].next( ), work++ ) {
+
+			slots.push_back( pos );
+			if( findPos( array[ pos ].object ) != head )
+				homes.push_back( findPos( array[ pos ].object ) );
+		}
+
+		/* The home address whose slot comes last in the list.  The old
+		 * records it drops are past its slot, so none of them is the home
+		 * slot of another record of the list.
+		*/
+		size_t home = END_OF_CHAIN;
+		for( size_t i = slots.size( ); ( i > 0 ) && ( home == END_OF_CHAIN ); i-- )
+			if( std::find( homes.begin( ), homes.end( ), slots[ i - 1 ] ) != homes.end( ) )
+				home = slots[ i - 1 ];
+
+		if( home == END_OF_CHAIN )
+			return work;
+
+		/*--- No empty slot left to move through, the list stays merged. ---*/
+		size_t moved = moveHome( head, home );
+		if( moved == 0 )
+			return work;
+
+		work += moved;
+	}
+}
+
+/* Gives the home address its own chain.  Its slot holds a record of
+ * another home address, which moves to an empty slot, and its records
+ * are copied into a new chain headed at the home slot.  The copies are
+ * linked in before the old records are unlinked, so the table stays
+ * whole if the empty slots run out half way.
+ * Returns the records moved, zero when there were not enough empty slots.
+*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::moveHome( size_t head, size_t home ) {
+
+	/*--- The slot before the home slot, and the records of the home address after it. ---*/
+	size_t before = head;
+	while( ( before != END_OF_CHAIN ) && ( array[ before ].next( ) != home ) )
+		before = array[ before ].next( );
+
+	if( before == END_OF_CHAIN )
+		return 0;
+
+	vector< size_t > records;
+	for( size_t pos = array[ home ].next( ); pos != END_OF_CHAIN; pos = array[ pos ].next( ) )
+		if( findPos( array[ pos ].object ) == home )
+			records.push_back( pos );
+
+	/*--- One slot for the displaced record, and one per record past the first. ---*/
+	vector< size_t > slots;
+	for( size_t i = 0; i < records.size( ); i++ ) {
+
+		size_t slot = emptySlot( home );
+		if( slot == END_OF_CHAIN ) {
+
+			for( size_t j = 0; j < slots.size( ); j++ )
+				release( slots[ j ] );
+
+			return 0;
+		}
+
+		/*--- Taken, so that the next search goes past it. ---*/
+		array.write( slot ).status = ACTIVE;
+		slots.push_back( slot );
+	}
+
+	/*--- The copies of the chain past its first record, not reachable yet. ---*/
+	for( size_t i = 1; i < records.size( ); i++ ) {
+
+		array.write( slots[ i ] ) = CoalescedHashingEntry( array[ records[ i ] ].object,
+			( i + 1 < records.size( ) ) ? slots[ i + 1 ] : END_OF_CHAIN, ACTIVE );
+
+		if( cacheMode )
+			setCacheState( slots[ i ], referenced[ records[ i ] ], ( ttl > 0 ) ? expiries[ records[ i ] ] : 0 );
+	}
+
+	/*--- The displaced record takes its copy's place in the list. ---*/
+	array.write( slots[ 0 ] ) = CoalescedHashingEntry( array[ home ].object, array[ home ].next( ), ACTIVE );
+	if( cacheMode )
+		setCacheState( slots[ 0 ], referenced[ home ], ( ttl > 0 ) ? expiries[ home ] : 0 );
+
+	array.write( before ).linkpos = ( Link )slots[ 0 ];
+
+	/*--- The home address now heads its own chain. ---*/
+	array.write( home ) = CoalescedHashingEntry( array[ records[ 0 ] ].object,
+		( records.size( ) > 1 ) ? slots[ 1 ] : END_OF_CHAIN, ACTIVE );
+
+	if( cacheMode )
+		setCacheState( home, referenced[ records[ 0 ] ], ( ttl > 0 ) ? expiries[ records[ 0 ] ] : 0 );
+
+	/*--- Last, drop the old records from the list. ---*/
+	size_t previous = head;
+	for( size_t pos = array[ head ].next( ); pos != END_OF_CHAIN; pos = array[ previous ].next( ) ) {
+
+		bool old = false;
+		for( size_t i = 0; ( i < records.size( ) ) && !old; i++ )
+			old = ( records[ i ] == pos );
+
+		if( old ) {
+
+			array.write( previous ).linkpos = array[ pos ].linkpos;
+			release( pos );
+		}
+
+		else
+			previous = pos;
+	}
+
+	defragClean = 0;
+	return records.size( ) + 1;
+}
+
+/*--- Marks the given slot empty and available to the insertions. ---*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::release( size_t pos ) {
+
+	CoalescedHashingEntry & entry = array.write( pos );
+	entry.status = EMPTY;
+	entry.linkpos = ( Link )END_OF_CHAIN;
+
+	/* The cursors only move down, so that finding an empty slot stays
+	 * amortized constant, and the slots freed above them are kept aside.
+	 * Those taken back as home addresses are dropped once they pile up.
+	*/
+	if( freeSlots.size( ) >= array.size( ) ) {
+
+		size_t kept = 0;
+		for( size_t i = 0; i < freeSlots.size( ); i++ )
+			if( array[ freeSlots[ i ] ].status != ACTIVE )
+				freeSlots[ kept++ ] = freeSlots[ i ];
+
+		freeSlots.resize( kept );
+	}
+
+	freeSlots.push_back( pos );
 }
 
 /*--- Find an item from the table. ---*/
-template < class Object >
-const_ref< Object > coalesced_hashing< Object >::find( const Object & object ) const {
+template < class Object, class Link >
+const_ref< Object > coalesced_hashing< Object, Link >::find( const Object & object ) const {
 
 	/*--- Get the position to insert the object. ---*/
-	int pos = findPos( object );
+	size_t pos = findPos( object );
 
 	/* Search in the probe chain for the given object
 	 * starting at the home address.
 	*/
-	SearchedResult result = findInProbeChain( object, pos );
+	SearchedResult result = lookup( object, pos );
 	if( result.probes == 0 ) /*--- Not found. ---*/
 		return const_ref< Object >( );
 
 	else /*--- return the object. ---*/
-		return const_ref< Object >( array[ result.pos ].object, array[ result.pos ].linkpos, result.probes );
+		return const_ref< Object >( array[ result.pos ].object, array[ result.pos ].next( ), result.probes );
+}
+
+/* Defends the table against hash flooding.  The hash function is
+ * seeded with a random per-table value, and every insertion that
+ * walks a chain of maxChainLength slots or more triggers a rehash
+ * of the table with a new seed.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::enableFloodingDefense( size_t maxChainLength ) {
+
+	this->maxChainLength = maxChainLength;
+
+	/*--- Move the records already stored to their seeded home address. ---*/
+	seeded = true;
+	rehash( );
+	rehashCount = 0;
+}
+
+/*--- Returns the number of rehashes triggered by long chains. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::rehashes( ) const {
+
+	return rehashCount;
+}
+
+/*--- Reinserts every record with a new random seed. ---*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::rehash( ) {
+
+	/*--- Draw a new seed, mixed with the clock in case the device is deterministic. ---*/
+	std::random_device device;
+	seed = ( ( unsigned long long ) device( ) << 32 ) ^ device( ) ^
+		( unsigned long long ) std::chrono::steady_clock::now( ).time_since_epoch( ).count( );
+
+	/*--- Insert the records back with the new seed. ---*/
+	reinsert( );
+
+	insertsSinceRehash = 0;
+	rehashCount++;
+}
+
+/*--- Takes out every record and inserts it back. ---*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::reinsert( ) {
+
+	/*--- Take out the records, with their reference bits and expiries in cache mode. ---*/
+	vector< Object > records;
+	vector< unsigned char > references;
+	vector< long long > expiry;
+	records.reserve( occupied );
+	for( size_t i = 0; i < array.size( ); i++ )
+		if( array[ i ].status == ACTIVE ) {
+
+			records.push_back( array[ i ].object );
+			if( cacheMode ) {
+
+				references.push_back( referenced[ i ] );
+				expiry.push_back( ( ttl > 0 ) ? expiries[ i ] : 0 );
+			}
+		}
+
+	clear( );
+	for( size_t i = 0; i < records.size( ); i++ ) {
+
+		size_t pos = findPos( records[ i ] );
+		InsertResult inserted = insertAfterSearch( records[ i ], pos, findInProbeChain( records[ i ], pos ) );
+
+		if( cacheMode )
+			setCacheState( inserted.pos, references[ i ], expiry[ i ] );
+	}
+}
+
+/* Splits the table into groups of the given number of slots, every
+ * group starts with its home addresses and ends with its own share
+ * of the cellar.  The records already stored are reinserted.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::enableLocalCellars( size_t groupSlots ) {
+
+	/*--- A page worth of slots by default. ---*/
+	if( groupSlots == 0 )
+		groupSlots = 4096 / sizeof( CoalescedHashingEntry );
+
+	this->groupSlots = ( groupSlots < array.size( ) ) ? groupSlots : array.size( );
+
+	/*--- Every group keeps the share of home addresses of the whole table. ---*/
+	double factor = ( addressFactor == -1.0 ) ? 1.0 : addressFactor;
+	groupHomes = ( size_t )( factor * this->groupSlots + 0.5 );
+	if( groupHomes < 1 )
+		groupHomes = 1;
+
+	/*--- The last group may be shorter. ---*/
+	size_t groups = ( array.size( ) + this->groupSlots - 1 ) / this->groupSlots;
+	size_t lastSlots = array.size( ) - ( groups - 1 ) * this->groupSlots;
+	addressSize = ( groups - 1 ) * groupHomes + ( ( lastSlots < groupHomes ) ? lastSlots : groupHomes );
+
+	groupCursors.resize( groups );
+	reinsert( );
+}
+
+/* Turns the table into a fixed-memory cache.  When the table is
+ * full, an insertion evicts a record picked by a CLOCK sweep and
+ * reuses its slot.  With a positive ttlSeconds, records expire that
+ * long after their insertion.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::enableCacheMode( double ttlSeconds ) {
+
+	/*--- A frozen table is read-only. ---*/
+	if( frozen )
+		throw IsFrozenException( );
+
+	cacheMode = true;
+	clockHand = 0;
+	ttl = ( ttlSeconds > 0.0 ) ? std::chrono::duration_cast< std::chrono::steady_clock::duration >(
+		std::chrono::duration< double >( ttlSeconds ) ).count( ) : 0;
+
+	/*--- The records already stored start cold, and live for a TTL from now. ---*/
+	referenced.assign( array.size( ), 0 );
+	if( ttl > 0 )
+		expiries.assign( array.size( ), expiryFromNow( ) );
+
+	else
+		expiries.clear( );
+}
+
+/*--- Returns true if the table is in cache mode. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::isCache( ) const {
+
+	return cacheMode;
+}
+
+/*--- Returns the counters of the cache mode. ---*/
+template < class Object, class Link >
+CacheStatistics coalesced_hashing< Object, Link >::cacheStatistics( ) const {
+
+	return statistics;
+}
+
+/*--- Returns the share of lookups that found a live record. ---*/
+template < class Object, class Link >
+double coalesced_hashing< Object, Link >::hitRatio( ) const {
+
+	size_t lookups = statistics.hits + statistics.misses;
+	return ( lookups > 0 ) ? ( double )statistics.hits / lookups : 0.0;
+}
+
+/* Unlinks a record picked by the CLOCK hand.  The hand clears the
+ * reference bits it passes and stops at the first record that is
+ * expired or was not referenced since the last sweep, so it goes
+ * around at most twice.
+*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::evict( ) {
+
+	for( ;; ) {
+
+		size_t pos = clockHand;
+		clockHand = ( clockHand + 1 < array.size( ) ) ? clockHand + 1 : 0;
+
+		if( array[ pos ].status != ACTIVE )
+			continue;
+
+		if( isExpired( pos ) )
+			statistics.expirations++;
+
+		else if( referenced[ pos ] ) { /*--- Second chance. ---*/
+
+			referenced[ pos ] = 0;
+			continue;
+		}
+
+		else
+			statistics.evictions++;
+
+		unlink( pos );
+		return;
+	}
+}
+
+/*--- Returns true if the record at the given slot outlived the TTL. ---*/
+template < class Object, class Link >
+bool coalesced_hashing< Object, Link >::isExpired( size_t pos ) const {
+
+	if( ttl == 0 )
+		return false;
+
+	return std::chrono::steady_clock::now( ).time_since_epoch( ).count( ) >= expiries[ pos ];
+}
+
+/*--- Returns the slot of an expired record equal to the object on its chain, or END_OF_CHAIN. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::findExpired( const Object & obj, size_t pos ) const {
+
+	for( ; pos != END_OF_CHAIN; pos = array[ pos ].next( ) )
+		if( ( array[ pos ].status == ACTIVE ) && ( obj == array[ pos ].object ) )
+			return pos;
+
+	return END_OF_CHAIN;
+}
+
+/*--- Sets the reference bit and the expiry of the record at the given slot. ---*/
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::setCacheState( size_t pos, unsigned char reference, long long expiry ) {
+
+	referenced[ pos ] = reference;
+	if( ttl > 0 )
+		expiries[ pos ] = expiry;
+}
+
+/*--- Returns the expiry of a record inserted now. ---*/
+template < class Object, class Link >
+long long coalesced_hashing< Object, Link >::expiryFromNow( ) const {
+
+	if( ttl == 0 )
+		return 0;
+
+	return std::chrono::steady_clock::now( ).time_since_epoch( ).count( ) + ttl;
+}
+
+/*--- Returns the slot of the given home address. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::homeSlot( size_t address ) const {
+
+	if( groupSlots == 0 )
+		return address;
+
+	return ( address / groupHomes ) * groupSlots + address % groupHomes;
 }
 
 /*--- Empty the table logically. ---*/
-template < class Object >
-void coalesced_hashing< Object >::clear( ) {
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::clear( ) {
 
 	occupied = 0;
 
+	/*--- The table accepts insertions again. ---*/
+	frozen = false;
+
+	/*--- Table Size - 1. ---*/
+	unoccupiedPos = array.size( ) - 1;
+	freeSlots.clear( );
+
+	/*--- Every group fills up from its bottom. ---*/
+	for( size_t group = 0; group < groupCursors.size( ); group++ )
+		groupCursors[ group ] = ( ( group + 1 ) * groupSlots < array.size( ) ) ? ( group + 1 ) * groupSlots : array.size( );
+
 	/*--- Clear the array. ---*/
-	for( int i = 0; i < array.size( ); i++ ) {
+	for( size_t i = 0; i < array.size( ); i++ ) {
 
 		/*--- Make the positions logically empty. ---*/
-		array[ i ].status = EMPTY;
+		array.write( i ).status = EMPTY;
 
 		/*--- Set link position. ---*/
-		array[ i ].linkpos = -1;
+		array.write( i ).linkpos = ( Link )END_OF_CHAIN;
 	}
 }
 
 /*--- Empties the table physically. ---*/
-template < class Object >
-void coalesced_hashing< Object >::empty( ) {
+template < class Object, class Link >
+void coalesced_hashing< Object, Link >::empty( ) {
 
 	occupied = 0;
 
 	/*--- Remove everything. ---*/
-	static_cast< void >( array.empty( ) );
-
-	/*--- Resize array. ---*/
-	array.resize( 0 );
+	slot_pages< CoalescedHashingEntry > none;
+	array.swap( none );
 }
 
 /*--- Returns the number of items currently within the table. ---*/
-template < class Object >
-int coalesced_hashing< Object >::elements( ) const {
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::elements( ) const {
 
 	return occupied;
 }
 
 /*--- Returns the size of the table. ---*/
-template < class Object >
-size_t coalesced_hashing< Object >::size( ) const {
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::size( ) const {
 
 	return array.size( );
 }
 
+/*--- Returns the number of bytes used by the slots of the table. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::memory( ) const {
+
+	return array.memory( ) +
+		referenced.capacity( ) * sizeof( unsigned char ) + expiries.capacity( ) * sizeof( long long );
+}
+
 /* If the given object is an not an integer,
  * this function will get called, else, the function
  * declared at the hashinghunction.h
  * Returns the hashing value associated with the given object.
 */
 template < class Object >
-int hash( const Object & obj ) {
+size_t hash( const Object & obj ) {
 
-	return reinterpret_cast< int >( &obj );
+	return reinterpret_cast< size_t >( &obj );
 }
 
-/*--- Returns the position for the given object. ---*/
+/* If the given object is an not an integer, its hashing value
+ * is mixed with the seed by the function declared at the
+ * hashingfunction.h
+*/
 template < class Object >
-int coalesced_hashing< Object >::findPos( const Object& obj ) const {
+unsigned long long hash( const Object & obj, unsigned long long seed ) {
 
-	/*--- Get position. ---*/
-	int pos = 0;
-	if( addressFactor != -1.0 )
-		pos = hash( obj ) % ( int )( addressFactor * array.size( ) );
+	return hash( ( unsigned long long )hash( obj ), seed );
+}
 
-	else
-		pos = hash( obj ) % array.size( );
+/*--- Searches the object for a lookup, counting the hit or miss in cache mode. ---*/
+template < class Object, class Link >
+SearchedResult coalesced_hashing< Object, Link >::lookup( const Object & obj, size_t pos ) const {
+
+	SearchedResult result = findInProbeChain( obj, pos );
+
+	if( cacheMode ) {
+
+		if( result.probes > 0 )
+			statistics.hits++;
 
-	/*--- Return the position. ---*/
-	return pos;
+		else
+			statistics.misses++;
+	}
+
+	return result;
+}
+
+/*--- Returns the position for the given object. ---*/
+template < class Object, class Link >
+size_t coalesced_hashing< Object, Link >::findPos( const Object& obj ) const {
+
+	/*--- The home address is always within the address region. ---*/
+	if( seeded )
+		return homeSlot( hash( obj, seed ) % addressSize );
+
+	return homeSlot( hash( obj ) % addressSize );
 }
 
 /* Searches the given object starting at the given
  * position till the end of probe chain.
 */
-template < class Object >
-SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj, size_t pos ) const {
+template < class Object, class Link >
+SearchedResult coalesced_hashing< Object, Link >::findInProbeChain( const Object & obj, size_t pos ) const {
 
 	/* Stores the prev item before the item to be remove
 	 * within the probe chain.
 	*/
-	size_t prevlink = -1;
+	size_t prevlink = END_OF_CHAIN;
 
 	/*--- To Store the Search Result. ---*/
 	SearchedResult result;
@@ -286,6 +1437,7 @@ SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj
 	*/
 	result.probes = 0;
 	result.pos = 0;
+	result.length = 0;
 
 	/*--- Flag is set to true, when the item is found. ---*/
 	bool itemFound = false;
@@ -294,10 +1446,16 @@ SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj
 		/*--- Increment number of probes. ---*/
 		result.probes++;
 
-		/*--- Check if this position contains the given item. ---*/
-		if( ( array[ pos ].status == ACTIVE ) && ( obj == array[ pos ].object ) ) {
+		/* Check if this position contains the given item.  In cache
+		 * mode an expired record is left for the CLOCK hand to reclaim
+		 * and the search goes on as if it did not match.
+		*/
+		if( ( array[ pos ].status == ACTIVE ) && ( obj == array[ pos ].object ) && !isExpired( pos ) ) {
+
+			/*--- Item was found, it is no longer cold. ---*/
+			if( cacheMode )
+				referenced[ pos ] = 1;
 
-			/*--- Item was found. ---*/
 			itemFound = true;
 			break;
 		}
@@ -306,10 +1464,13 @@ SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj
 		prevlink = pos;
 
 		/*--- find the next link position. ---*/
-		pos = array[ pos ].linkpos;
+		pos = array[ pos ].next( );
+
+		/*--- If there is no link, then we reached end of probe chain. ---*/
+	}while ( pos != END_OF_CHAIN );
 
-		/*--- If position is -1, then we reached end of probe chain. ---*/
-	}while ( pos > -1 );
+	/*--- Number of slots visited. ---*/
+	result.length = result.probes;
 
 	/*--- If the item was not found, then throw an exception. ---*/
 	if( !itemFound ) {
@@ -322,7 +1483,7 @@ SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj
 				result.pos = prevlink;
 
 			else /*--- This will implied that the home address is available. ---*/
-				result.pos = -1;
+				result.pos = END_OF_CHAIN;
 		}
 
 		else {
@@ -343,42 +1504,4 @@ SearchedResult coalesced_hashing< Object >::findInProbeChain( const Object & obj
 
 	/*--- Return the search result. ---*/
 	return result;
-}
-
-/*--- Returns true if the given number is a prime. ---*/
-template < class Object >
-bool coalesced_hashing< Object >::isPrime( int n ) {
-
-	if( n == 2 )
-		return true;
-
-	if( n == 1 || n % 2 == 0 )
-		return false;
-
-	/*--- Get the Square Root of n and add 1. ---*/
-	int sqrtOf_n = ( int )sqrt( ( double ) n ) + 1;
-
-	/*--- Now, try to check if n is a prime. ---*/
-	for( int i = 3; i < sqrtOf_n; i += 2 )
-		if( n % i == 0 )
-			return false;
-
-	return true;
-}
-
-/* Function to find the Next Prime.
- * Assuming n > 0.
-*/
-template < class Object >
-int coalesced_hashing< Object >::nextPrime( int n ) {
-
-	/*--- If it is not even, increment to make it odd. ---*/
-	if( n % 2 == 0 )
-		n++;
-
-	/*--- Now find the next prime number. ---*/
-	for( ; !isPrime( n ); n += 2 )
-		;
-
-	return n;
 }
\ No newline at end of file
@@ -27,6 +27,8 @@
 #define __COALESCED_HASHING_H_H__
 
 #include "const_ref.h"
+#include "slotpages.h"
+#include "lookupscheduler.h"
 #include <vector>
 using std::vector;
 
@@ -34,7 +36,7 @@ using std::vector;
 struct SearchedResult {
 
 	/* Stores the number of probes taken to find the element. ---*/
-	int probes;
+	size_t probes;
 
 	/* Stores the position where the element is found.
 	 * If the number of probes is zero, then
@@ -42,6 +44,54 @@ struct SearchedResult {
 	 * last element within the probe chain.
 	*/
 	size_t pos;
+
+	/*--- Stores the number of slots visited, whether or not the element was found. ---*/
+	size_t length;
+};
+
+/*--- Link value that marks the end of a probe chain. ---*/
+const size_t END_OF_CHAIN = ( size_t ) -1;
+
+/*--- Outcome of the non-throwing insertion functions. ---*/
+enum InsertStatus { INSERTED, DUPLICATE, FULL, FROZEN };
+
+/*--- Structure returned by the non-throwing insertion functions. ---*/
+struct InsertResult {
+
+	/*--- Stores whether the object was inserted, already stored, or could not be inserted. ---*/
+	InsertStatus status;
+
+	/* Stores the slot holding the object, either the new
+	 * slot or the slot of the stored duplicate.
+	 * It is END_OF_CHAIN when nothing was inserted.
+	*/
+	size_t pos;
+};
+
+/*--- Counters of a table in cache mode. ---*/
+struct CacheStatistics {
+
+	/*--- Lookups that found a live record, and lookups that did not. ---*/
+	size_t hits, misses;
+
+	/*--- Cold records evicted to make room for an insertion. ---*/
+	size_t evictions;
+
+	/*--- Expired records reclaimed to make room for an insertion. ---*/
+	size_t expirations;
+};
+
+/*--- Shape of the chains of a table. ---*/
+struct ChainStatistics {
+
+	/*--- Lists of linked records, and those holding the records of several home addresses. ---*/
+	size_t chains, mergedChains;
+
+	/*--- Number of records of the longest list. ---*/
+	size_t longestChain;
+
+	/*--- Mean number of probes of a successful lookup, over every record. ---*/
+	double meanProbes;
 };
 
 /**
@@ -58,31 +108,223 @@ struct SearchedResult {
  *
  *    LICH (late insert coalesced hashing)
  *    EICH (early insert coalesced hashing)
+ *
+ * => Links are stored as Link, an unsigned integer type whose largest
+ *    value ends a chain.  An unsigned int halves the links of tables
+ *    below 2^32 - 1 slots, a size_t lets the table grow past them.
 */
 
+template < class Object, class Link = size_t >
+class coalesced_snapshot;
+
 template < class Object >
+class durable_coalesced_hashing;
+
+template < class Object, class Link = size_t >
 class coalesced_hashing {
 
+	friend class coalesced_snapshot< Object, Link >;
+	friend class durable_coalesced_hashing< Object >;
+
 	public:
 
+		/* Combines an incoming object into the stored object equal to it.
+		 * It must not change what the equality and the hash depend on.
+		*/
+		typedef void ( *MergeFunction )( Object & stored, const Object & incoming );
+
 		/*--- Constructor. ---*/
-		coalesced_hashing( int size, bool eisch );
+		coalesced_hashing( size_t size, bool eisch );
 
 		/*--- Constructor. ---*/
-		coalesced_hashing( int size, bool eich, const double & addressFactor );
+		coalesced_hashing( size_t size, bool eich, const double & addressFactor );
 
 		/*--- Insert into the table. ---*/
 		void insert( const Object & object );
 
-		/* Removes the item from the table.
-		 * This function is not currently implemented
-		 * at this time.
+		/* Insert into the table without throwing.
+		 * Returns the status together with the slot of the object.
+		*/
+		InsertResult try_insert( const Object & object );
+
+		/* Returns the stored object equal to the given one, inserting
+		 * it first when missing.  The chain is walked only once.
+		 * Returns NULL when the object is missing and the table is full.
+		*/
+		const Object * insert_or_find( const Object & object );
+
+		/* Merges the object into the stored object equal to it, or inserts
+		 * it as the initial value when missing, walking the chain once.
+		 * Returns DUPLICATE with the slot of the merged object, INSERTED
+		 * with the new slot, or FULL.  A frozen table still merges into
+		 * the objects it holds and reports FROZEN for missing ones.
+		*/
+		InsertResult upsert( const Object & object, MergeFunction merge );
+
+		/* Upserts the given objects in order.  The home slots of the
+		 * objects ahead are prefetched while the current one is merged.
+		 * Returns the number of objects applied, which is less than the
+		 * count when the table became full or is frozen.
+		*/
+		size_t upsert( const Object * objects, size_t count, MergeFunction merge );
+
+		/* Removes the item from the table.  The records that follow it
+		 * in its chain are inserted again, so no chain is left broken.
+		 * Returns 1 when removed, 0 when not stored and -1 when frozen.
 		*/
 		int remove( const Object& object );
 
 		/*--- Find an item from the table. ---*/
 		const_ref< Object > find( const Object & object ) const;
 
+		/*--- Returns true if the item is stored in the table. ---*/
+		bool contains( const Object & object ) const;
+
+		/* Looks up the given objects in order, prefetching the home
+		 * slots of the objects ahead.  found[ i ] tells whether
+		 * objects[ i ] is stored.  Returns the number of objects found.
+		*/
+		size_t contains( const Object * objects, size_t count, bool * found ) const;
+
+		/* Find an item from the table without throwing.
+		 * Returns NULL when the item is not stored.
+		*/
+		const Object * try_find( const Object & object ) const;
+
+#if defined( __cpp_impl_coroutine )
+		/*--- Lookup suspended at every slot of the probe chain, awaited by a lookup_task. ---*/
+		class find_awaiter : public lookup_step {
+
+			public:
+
+				/*--- Prefetches the home slot of the object. ---*/
+				find_awaiter( const coalesced_hashing * table, const Object & object );
+
+				/*--- Never ready, the home slot is read on the next turn. ---*/
+				bool await_ready( ) const;
+
+				/*--- Hands the lookup to the scheduler of the request. ---*/
+				void await_suspend( lookup_task::handle_type handle );
+
+				/*--- Returns the object found, as find( ) does. ---*/
+				const_ref< Object > await_resume( ) const;
+
+				/*--- Looks at the current slot, and prefetches the next one. ---*/
+				bool step( );
+
+			private:
+
+				const coalesced_hashing * table;
+				Object object;
+
+				/*--- Slot looked at by the next step. ---*/
+				size_t pos;
+
+				size_t probes;
+				bool found;
+		};
+
+		/* Finds an item from within a lookup_task, co_await table.async_find( object )
+		 * gives what find( ) would.  The lookup takes one chain hop per turn of
+		 * the scheduler, prefetching the next slot before it suspends, so the
+		 * hops of other requests hide the load.  The table must not be modified
+		 * while lookups are in flight.
+		*/
+		find_awaiter async_find( const Object & object ) const;
+#endif
+
+		/*--- Returns the object stored at the given slot. ---*/
+		const Object & objectAt( size_t pos ) const;
+
+		/*--- Returns true if the given slot holds an object. ---*/
+		bool isOccupied( size_t pos ) const;
+
+		/* Rewrites the table into a read-only layout where every chain
+		 * only holds the records of its own home address, in the free
+		 * slots nearest after it.  The table keeps its size.  find( )
+		 * results are unchanged, insertions report FROZEN until the
+		 * table is cleared.
+		*/
+		void freeze( );
+
+		/*--- Returns true if the table was frozen. ---*/
+		bool isFrozen( ) const;
+
+		/* Returns a read-only view of the table as it is now.  The view
+		 * shares the slots with the table a page at a time, and the
+		 * table copies a page the first time it writes it after the
+		 * view was taken, until every view is released.  A table that
+		 * took no view writes its slots in place.  The view may be read
+		 * and released by another thread while this one keeps writing
+		 * the table.
+		*/
+		coalesced_snapshot< Object, Link > snapshot( ) const;
+
+		/* Defends the table against hash flooding.  The hash function is
+		 * seeded with a random per-table value, and every insertion that
+		 * walks a chain of maxChainLength slots or more triggers a rehash
+		 * of the table with a new seed.  Rehashes are spaced so that
+		 * their cost stays amortized over the insertions: one waits for a
+		 * quarter of the records to be inserted since the last.  Only
+		 * insertions are watched, so until that rehash happens the
+		 * lookups of a flooded chain stay as long as the chain.
+		*/
+		void enableFloodingDefense( size_t maxChainLength );
+
+		/*--- Returns the number of rehashes triggered by long chains. ---*/
+		size_t rehashes( ) const;
+
+		/* Splits the table into groups of the given number of slots, a
+		 * page by default.  Every group starts with its home addresses
+		 * and ends with its own share of the cellar, and a colliding
+		 * record goes to the bottommost empty slot of the group of its
+		 * home address.  Only a full group spills into the bottommost
+		 * empty slot of the whole table, so most chains stay within a
+		 * page.  The records already stored are reinserted.
+		*/
+		void enableLocalCellars( size_t groupSlots = 0 );
+
+		/* Turns the table into a fixed-memory cache.  When the table is
+		 * full, an insertion evicts a record picked by a CLOCK sweep
+		 * over per-slot reference bits, set by every lookup that finds
+		 * the record, and reuses its slot instead of failing.  With a
+		 * positive ttlSeconds, a record expires that long after its
+		 * insertion; lookups no longer see it and it is the first to be
+		 * reclaimed.  Lookups update the reference bits and the
+		 * counters, so a table in cache mode must not be shared by
+		 * concurrent readers.
+		*/
+		void enableCacheMode( double ttlSeconds = 0.0 );
+
+		/*--- Returns true if the table is in cache mode. ---*/
+		bool isCache( ) const;
+
+		/*--- Returns the counters of the cache mode. ---*/
+		CacheStatistics cacheStatistics( ) const;
+
+		/*--- Returns the share of lookups that found a live record. ---*/
+		double hitRatio( ) const;
+
+		/*--- Returns the number of chains, how many are merged, and the mean probes. ---*/
+		ChainStatistics chainStatistics( ) const;
+
+		/* Undoes coalescence a little at a time.  Visits the home
+		 * addresses from where the last call stopped, and rebuilds every
+		 * list of records holding the records of several home addresses,
+		 * so that each of them heads a chain of its own records.  Stops
+		 * after budget units of work, a slot visited or a record moved.
+		 * The links are plain fields, so call it between operations, never
+		 * while another thread looks the table up.
+		 * Returns the work done, which is below the budget once a whole
+		 * pass found nothing left to separate, and zero until the table
+		 * changes again.  The table is consistent after every call, and
+		 * the snapshots are not affected.
+		*/
+		size_t defragment( size_t budget );
+
+		/*--- Defragments for about the given number of seconds, returns the work done. ---*/
+		size_t defragmentFor( double seconds );
+
 		/*--- Empty the table logically. ---*/
 		void clear( );
 
@@ -90,28 +332,88 @@ class coalesced_hashing {
 		void empty( );
 
 		/*--- Returns the number of items currently within the table. ---*/
-		int elements( ) const;
+		size_t elements( ) const;
 
 		/*--- Returns the size of the table. ---*/
 		size_t size( ) const;
 
+		/*--- Returns the number of bytes used by the slots of the table. ---*/
+		size_t memory( ) const;
+
 	private: /*--- Private Functions. ---*/
 
 		/*--- Returns the position for the given object. ---*/
-		int findPos( const Object & obj ) const;
+		size_t findPos( const Object & obj ) const;
 
 		/* Searches the given object starting at the given
 		 * position till the end of probe chain.
 		*/
 		SearchedResult findInProbeChain( const Object & obj, size_t pos ) const;
 
-		/*--- Returns true if the given number is a prime. ---*/
-		bool isPrime( int n );
+		/* Inserts the object once its probe chain has been searched
+		 * and the object was not found in it.
+		*/
+		InsertResult insertAfterSearch( const Object & object, size_t pos, const SearchedResult & result );
+
+		/* Searches the object from its home address and inserts it when
+		 * missing, or merges it into the stored one when a merge is given.
+		*/
+		InsertResult insertFromHome( const Object & object, size_t pos, MergeFunction merge );
+
+		/*--- Reinserts every record with a new random seed. ---*/
+		void rehash( );
+
+		/*--- Takes out every record and inserts it back. ---*/
+		void reinsert( );
+
+		/*--- Returns the slot of the given home address. ---*/
+		size_t homeSlot( size_t address ) const;
+
+		/*--- Returns the first free slot after the given one during freeze( ). ---*/
+		static size_t freeSlotAfter( vector< size_t > & vacant, size_t pos );
+
+		/*--- Returns the bottommost empty slot for a record colliding at pos, or END_OF_CHAIN. ---*/
+		size_t emptySlot( size_t pos );
 
-		/* Function to find the Next Prime.
-		 * Assuming n > 0.
+		/*--- Searches the object for a lookup, counting the hit or miss in cache mode. ---*/
+		SearchedResult lookup( const Object & obj, size_t pos ) const;
+
+		/*--- Returns the slot linking to the given slot, or END_OF_CHAIN. ---*/
+		size_t predecessor( size_t pos ) const;
+
+		/* Takes the record at the given slot out of its chain and
+		 * inserts the records that followed it again.
+		*/
+		void unlink( size_t pos );
+
+		/*--- Marks the given slot empty and available to the insertions. ---*/
+		void release( size_t pos );
+
+		/* Rebuilds the list headed at the given slot so that every home
+		 * address in it heads its own chain.  Returns the work done.
 		*/
-		int nextPrime( int n );
+		size_t separate( size_t head );
+
+		/* Moves the records of the given home address, within the list
+		 * headed at head, to a chain of their own.  Returns the records
+		 * moved, zero when there were not enough empty slots.
+		*/
+		size_t moveHome( size_t head, size_t home );
+
+		/*--- Unlinks a record picked by the CLOCK hand. ---*/
+		void evict( );
+
+		/*--- Returns true if the record at the given slot outlived the TTL. ---*/
+		bool isExpired( size_t pos ) const;
+
+		/*--- Returns the slot of an expired record equal to the object on its chain, or END_OF_CHAIN. ---*/
+		size_t findExpired( const Object & obj, size_t pos ) const;
+
+		/*--- Sets the reference bit and the expiry of the record at the given slot. ---*/
+		void setCacheState( size_t pos, unsigned char reference, long long expiry );
+
+		/*--- Returns the expiry of a record inserted now. ---*/
+		long long expiryFromNow( ) const;
 
 	private: /*--- Private attributes. ---*/
 
@@ -124,20 +426,23 @@ class coalesced_hashing {
 			Object object;
 
 			/*--- Link position within chain. ---*/
-			size_t linkpos;
+			Link linkpos;
 
-			/*--- Stores the entry status. ---*/
-			EntryStatus status;
+			/*--- Stores the entry status, a byte is enough. ---*/
+			unsigned char status;
 
 			/*--- Constructor. ---*/
 			CoalescedHashingEntry( const Object & obj = Object( ),
-				int pos = -1, EntryStatus s = EMPTY ) : object( obj ),
-					linkpos( pos ), status( s ) { }
+				size_t pos = END_OF_CHAIN, EntryStatus s = EMPTY ) : object( obj ),
+					linkpos( ( Link )pos ), status( ( unsigned char )s ) { }
+
+			/*--- Returns the link position, END_OF_CHAIN at the end of the chain. ---*/
+			size_t next( ) const { return ( linkpos == ( Link ) -1 ) ? END_OF_CHAIN : ( size_t )linkpos; }
 
 		};
 
 		/*--- Stores the number of entries currently stored. ---*/
-		int occupied;
+		size_t occupied;
 
 		/*--- Algorith to use, default is late insertion. ---*/
 		bool eisch_algorithm;
@@ -145,11 +450,66 @@ class coalesced_hashing {
 		/*--- Stores the ratio of the primary area to the total table size. ---*/
 		double addressFactor;
 
+		/*--- Number of slots that can be a home address. ---*/
+		size_t addressSize;
+
+		/*--- Set once the table has been frozen. ---*/
+		bool frozen;
+
+		/*--- Set when the hash function is seeded. ---*/
+		bool seeded;
+
+		/*--- Seed of the hash function. ---*/
+		unsigned long long seed;
+
+		/*--- Chain length that triggers a rehash, zero when not watched. ---*/
+		size_t maxChainLength;
+
+		/*--- Insertions since the last rehash. ---*/
+		size_t insertsSinceRehash;
+
+		/*--- Number of rehashes triggered by long chains. ---*/
+		size_t rehashCount;
+
 		/*--- position to insert the incoming item during insertion. ---*/
 		size_t unoccupiedPos;
 
-		/*--- Array to store the Entries. ---*/
-		vector< CoalescedHashingEntry > array;
+		/*--- Slots and home addresses per group, zero for a single cellar. ---*/
+		size_t groupSlots;
+		size_t groupHomes;
+
+		/*--- Per group, one past the bottommost slot that may be empty. ---*/
+		vector< size_t > groupCursors;
+
+		/*--- Slots freed by removals and evictions above the cursors. ---*/
+		vector< size_t > freeSlots;
+
+		/*--- Set once the table is in cache mode. ---*/
+		bool cacheMode;
+
+		/*--- Slot the CLOCK hand looks at next. ---*/
+		size_t clockHand;
+
+		/*--- Lifetime of a record in steady clock ticks, zero for none. ---*/
+		long long ttl;
+
+		/*--- Per slot, set by the lookups and cleared by the CLOCK hand. ---*/
+		mutable vector< unsigned char > referenced;
+
+		/*--- Per slot, steady clock time the record expires at, when a TTL is set. ---*/
+		vector< long long > expiries;
+
+		/*--- Counters of the cache mode. ---*/
+		mutable CacheStatistics statistics;
+
+		/*--- Home address the next defragmentation starts at. ---*/
+		size_t defragCursor;
+
+		/*--- Home addresses found clean since the last change of the table. ---*/
+		size_t defragClean;
+
+		/*--- Array to store the Entries, in pages shared with the snapshots. ---*/
+		slot_pages< CoalescedHashingEntry > array;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include "coalescedsnapshot.h"
+#include "hashingfunction.h"
+
+/*--- Constructor, takes a view of the given table. ---*/
+template < class Object, class Link >
+coalesced_snapshot< Object, Link >::coalesced_snapshot( const coalesced_hashing< Object, Link > & table )
+	: array( table.array.share( ) ), occupied( table.occupied ), addressSize( table.addressSize ),
+		groupSlots( table.groupSlots ), groupHomes( table.groupHomes ),
+		seeded( table.seeded ), seed( table.seed ) {
+
+}
+
+/*--- Find an item from the view. ---*/
+template < class Object, class Link >
+const_ref< Object > coalesced_snapshot< Object, Link >::find( const Object & object ) const {
+
+	SearchedResult result = findInProbeChain( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return const_ref< Object >( );
+
+	return const_ref< Object >( array[ result.pos ].object, array[ result.pos ].next( ), result.probes );
+}
+
+/*--- Returns true if the item is stored in the view. ---*/
+template < class Object, class Link >
+bool coalesced_snapshot< Object, Link >::contains( const Object & object ) const {
+
+	return findInProbeChain( object, findPos( object ) ).probes > 0;
+}
+
+/* Find an item from the view without throwing.
+ * Returns NULL when the item is not stored.
+*/
+template < class Object, class Link >
+const Object * coalesced_snapshot< Object, Link >::try_find( const Object & object ) const {
+
+	SearchedResult result = findInProbeChain( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return NULL;
+
+	return &array[ result.pos ].object;
+}
+
+/*--- Returns the object stored at the given slot. ---*/
+template < class Object, class Link >
+const Object & coalesced_snapshot< Object, Link >::objectAt( size_t pos ) const {
+
+	return array[ pos ].object;
+}
+
+/*--- Returns true if the given slot holds an object. ---*/
+template < class Object, class Link >
+bool coalesced_snapshot< Object, Link >::isOccupied( size_t pos ) const {
+
+	return array[ pos ].status == coalesced_hashing< Object, Link >::ACTIVE;
+}
+
+/*--- Returns the slot the given slot links to, END_OF_CHAIN at the end of a chain. ---*/
+template < class Object, class Link >
+size_t coalesced_snapshot< Object, Link >::linkAt( size_t pos ) const {
+
+	return array[ pos ].next( );
+}
+
+/*--- Returns the number of items within the view. ---*/
+template < class Object, class Link >
+size_t coalesced_snapshot< Object, Link >::elements( ) const {
+
+	return occupied;
+}
+
+/*--- Returns the number of slots of the view. ---*/
+template < class Object, class Link >
+size_t coalesced_snapshot< Object, Link >::size( ) const {
+
+	return array.size( );
+}
+
+/*--- Returns the position for the given object, as the table computed it. ---*/
+template < class Object, class Link >
+size_t coalesced_snapshot< Object, Link >::findPos( const Object & obj ) const {
+
+	size_t address = ( seeded ? hash( obj, seed ) : hash( obj ) ) % addressSize;
+
+	if( groupSlots == 0 )
+		return address;
+
+	return ( address / groupHomes ) * groupSlots + address % groupHomes;
+}
+
+/* Searches the given object starting at the given position
+ * till the end of probe chain.
+*/
+template < class Object, class Link >
+SearchedResult coalesced_snapshot< Object, Link >::findInProbeChain( const Object & obj, size_t pos ) const {
+
+	SearchedResult result = { 0, END_OF_CHAIN, 0 };
+
+	for( ; pos != END_OF_CHAIN; pos = array[ pos ].next( ) ) {
+
+		result.length++;
+
+		/*--- Check if this position contains the given item. ---*/
+		if( ( array[ pos ].status == coalesced_hashing< Object, Link >::ACTIVE ) && ( obj == array[ pos ].object ) ) {
+
+			result.probes = result.length;
+			result.pos = pos;
+			break;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,113 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __COALESCED_SNAPSHOT_H__
+#define __COALESCED_SNAPSHOT_H__
+
+#include "coalescedhashing.h"
+#include "const_ref.h"
+
+/**
+ * Read-only view of a coalesced_hashing table, as returned by
+ * coalesced_hashing::snapshot( ).
+ *
+ * => The view shares the slot pages of the table and their table of
+ *    pages, so taking it copies no slot.  The first write that follows
+ *    copies the table of pages, one pointer per page, and the writes copy
+ *    the pages they touch only.  Once every view is released the table
+ *    writes its slots in place again.
+ *
+ * => find( ) and the iteration over the slots see the table exactly as
+ *    it was when the view was taken, while the table keeps changing.
+ *    A view of a table in cache mode does not track the reference bits
+ *    and holds the records that were stored, expired or not.
+*/
+
+template < class Object, class Link >
+class coalesced_snapshot {
+
+	public:
+
+		/*--- Constructor, takes a view of the given table. ---*/
+		coalesced_snapshot( const coalesced_hashing< Object, Link > & table );
+
+		/*--- Find an item from the view. ---*/
+		const_ref< Object > find( const Object & object ) const;
+
+		/*--- Returns true if the item is stored in the view. ---*/
+		bool contains( const Object & object ) const;
+
+		/* Find an item from the view without throwing.
+		 * Returns NULL when the item is not stored.
+		*/
+		const Object * try_find( const Object & object ) const;
+
+		/*--- Returns the object stored at the given slot. ---*/
+		const Object & objectAt( size_t pos ) const;
+
+		/*--- Returns true if the given slot holds an object. ---*/
+		bool isOccupied( size_t pos ) const;
+
+		/*--- Returns the slot the given slot links to, END_OF_CHAIN at the end of a chain. ---*/
+		size_t linkAt( size_t pos ) const;
+
+		/*--- Returns the number of items within the view. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the number of slots of the view. ---*/
+		size_t size( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		typedef typename coalesced_hashing< Object, Link >::CoalescedHashingEntry Entry;
+
+		/*--- Returns the position for the given object. ---*/
+		size_t findPos( const Object & obj ) const;
+
+		/* Searches the given object starting at the given position
+		 * till the end of probe chain.  The probes are zero when the
+		 * object is not stored.
+		*/
+		SearchedResult findInProbeChain( const Object & obj, size_t pos ) const;
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- Slots of the table, shared with it a page at a time. ---*/
+		slot_pages< Entry > array;
+
+		/*--- Number of entries stored when the view was taken. ---*/
+		size_t occupied;
+
+		/*--- Home addresses of the table, and their layout with local cellars. ---*/
+		size_t addressSize;
+		size_t groupSlots;
+		size_t groupHomes;
+
+		/*--- Seed of the hash function of the table, when seeded. ---*/
+		bool seeded;
+		unsigned long long seed;
+};
+
+#endif
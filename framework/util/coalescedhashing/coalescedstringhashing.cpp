@@ -0,0 +1,433 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <string.h>
+#include "coalescedstringhashing.h"
+#include "hashingfunction.h"
+#include "primes.h"
+#include "exceptions.h"
+
+/**
+ * Coalesced hashing table specialized for string keys.
+ *
+ * => Every slot keeps the full 64-bit hash of its key, so almost
+ *    every probe is resolved by comparing hashes without touching
+ *    the key bytes.
+ *
+ * => Keys of up to INLINE_KEY_LENGTH bytes are stored inside the
+ *    slot, longer keys are appended to a single contiguous arena
+ *    and the slot keeps their offset.
+*/
+
+/*--- Constructor. ---*/
+coalesced_string_hashing::coalesced_string_hashing( size_t size, bool eisch )
+	: eisch_algorithm( eisch ), array( nextPrime( size ) ) {
+
+	/*--- Default address factor. ---*/
+	addressFactor = -1.0;
+
+	/*--- Clear array. ---*/
+	clear( );
+}
+
+/*--- Constructor. ---*/
+coalesced_string_hashing::coalesced_string_hashing( size_t size, bool eich, const double & addressFactor )
+	: eisch_algorithm( eich ), array( nextPrime( size ) ) {
+
+	/*--- Set address factor. ---*/
+	this->addressFactor = addressFactor;
+
+	/*--- Default in case is less than zero or greater than 1. ---*/
+	if( ( this->addressFactor < 0.0 ) || ( this->addressFactor > 1.0 ) )
+		this->addressFactor = 0.86;
+
+	/*--- Clear array. ---*/
+	clear( );
+}
+
+/*--- Insert into the table. ---*/
+void coalesced_string_hashing::insert( string_view key ) {
+
+	InsertStatus status = try_insert( key ).status;
+
+	if( status == DUPLICATE )
+		throw DuplicateItemException( );
+
+	else if( status == FULL )
+		throw IsFullException( );
+}
+
+/* Insert into the table without throwing, but for keys longer than
+ * MAX_KEY_LENGTH.  Returns the status together with the slot of the key.
+*/
+InsertResult coalesced_string_hashing::try_insert( string_view key ) {
+
+	if( key.size( ) > MAX_KEY_LENGTH )
+		throw KeyTooLongException( );
+
+	/*--- The hash is computed once and kept in the slot. ---*/
+	unsigned long long hashValue = hash( key.data( ), key.size( ) );
+
+	/*--- Get the position to insert the key. ---*/
+	size_t pos = findPos( hashValue );
+
+	/* Search in the probe chain for the given key
+	 * starting at the home address.
+	*/
+	SearchedResult result = findInProbeChain( key, hashValue, pos );
+	if( result.probes > 0 ) { /*--- Already stored. ---*/
+
+		InsertResult duplicate = { DUPLICATE, result.pos };
+		return duplicate;
+	}
+
+	size_t slot = freeSlot( pos, result );
+	if( slot == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	/*--- Insert the item and link it into the chain. ---*/
+	store( slot, key, hashValue );
+	link( slot, pos, result );
+
+	/*--- Increase occupied variable. ---*/
+	occupied++;
+
+	InsertResult inserted = { INSERTED, slot };
+	return inserted;
+}
+
+/* Removes the key from the table.  The records that follow it
+ * in its chain are inserted again, so no chain is left broken.
+ * Returns 1 when removed and 0 when not stored.
+*/
+int coalesced_string_hashing::remove( string_view key ) {
+
+	unsigned long long hashValue = hash( key.data( ), key.size( ) );
+
+	SearchedResult result = findInProbeChain( key, hashValue, findPos( hashValue ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return 0;
+
+	size_t pos = result.pos;
+
+	/* Cut the chain before the record.  A record is only ever linked
+	 * from the chain of its home address.
+	*/
+	for( size_t prev = findPos( array[ pos ].hashValue ); ( prev != pos ) && ( prev != END_OF_CHAIN ); prev = array[ prev ].linkpos )
+		if( array[ prev ].linkpos == pos ) {
+
+			array[ prev ].linkpos = END_OF_CHAIN;
+			break;
+		}
+
+	/*--- Take out the record and the rest of its chain, the long keys stay in the arena. ---*/
+	vector< StringHashingEntry > records;
+	for( size_t next = array[ pos ].linkpos; next != END_OF_CHAIN; next = array[ next ].linkpos )
+		records.push_back( array[ next ] );
+
+	for( size_t next = array[ pos ].linkpos; next != END_OF_CHAIN; ) {
+
+		size_t following = array[ next ].linkpos;
+		release( next );
+		next = following;
+	}
+
+	if( array[ pos ].length > INLINE_KEY_LENGTH )
+		arenaGarbage += array[ pos ].length;
+
+	release( pos );
+	occupied -= records.size( ) + 1;
+
+	/*--- Insert the rest of the chain again, they fit in the slots just freed. ---*/
+	for( size_t i = 0; i < records.size( ); i++ ) {
+
+		size_t home = findPos( records[ i ].hashValue );
+
+		/*--- The record is not stored, so the search only finds the end of the chain. ---*/
+		SearchedResult end;
+		end.probes = 0;
+		end.pos = END_OF_CHAIN;
+		end.length = 0;
+		if( array[ home ].status == ACTIVE )
+			for( end.pos = home; array[ end.pos ].linkpos != END_OF_CHAIN; end.pos = array[ end.pos ].linkpos );
+
+		size_t slot = freeSlot( home, end );
+		array[ slot ] = records[ i ];
+		array[ slot ].linkpos = END_OF_CHAIN;
+		link( slot, home, end );
+		occupied++;
+	}
+
+	if( arenaGarbage * 2 > arena.size( ) )
+		compact( );
+
+	return 1;
+}
+
+/*--- Find an item from the table. ---*/
+string_ref coalesced_string_hashing::find( string_view key ) const {
+
+	unsigned long long hashValue = hash( key.data( ), key.size( ) );
+
+	/* Search in the probe chain for the given key
+	 * starting at the home address.
+	*/
+	SearchedResult result = findInProbeChain( key, hashValue, findPos( hashValue ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return string_ref( );
+
+	else /*--- return the key. ---*/
+		return string_ref( keyAt( result.pos ), array[ result.pos ].linkpos, result.probes );
+}
+
+/*--- Returns true if the key is stored in the table. ---*/
+bool coalesced_string_hashing::contains( string_view key ) const {
+
+	unsigned long long hashValue = hash( key.data( ), key.size( ) );
+
+	return findInProbeChain( key, hashValue, findPos( hashValue ) ).probes > 0;
+}
+
+/*--- Empty the table logically. ---*/
+void coalesced_string_hashing::clear( ) {
+
+	occupied = 0;
+
+	/*--- Table Size - 1. ---*/
+	unoccupiedPos = array.size( ) - 1;
+
+	/*--- Clear the array. ---*/
+	for( size_t i = 0; i < array.size( ); i++ ) {
+
+		/*--- Make the positions logically empty. ---*/
+		array[ i ].status = EMPTY;
+
+		/*--- Set link position. ---*/
+		array[ i ].linkpos = END_OF_CHAIN;
+	}
+
+	/*--- The arena is rebuilt by the next insertions. ---*/
+	arena.clear( );
+	arenaGarbage = 0;
+}
+
+/*--- Empties the table physically. ---*/
+void coalesced_string_hashing::empty( ) {
+
+	occupied = 0;
+	unoccupiedPos = END_OF_CHAIN;
+
+	/*--- Remove everything. ---*/
+	vector< StringHashingEntry >( ).swap( array );
+	vector< char >( ).swap( arena );
+	arenaGarbage = 0;
+}
+
+/*--- Returns the number of items currently within the table. ---*/
+size_t coalesced_string_hashing::elements( ) const {
+
+	return occupied;
+}
+
+/*--- Returns the size of the table. ---*/
+size_t coalesced_string_hashing::size( ) const {
+
+	return array.size( );
+}
+
+/*--- Returns the number of bytes used by the key arena. ---*/
+size_t coalesced_string_hashing::arenaSize( ) const {
+
+	return arena.size( );
+}
+
+/*--- Returns the home position for the given hash value. ---*/
+size_t coalesced_string_hashing::findPos( unsigned long long hashValue ) const {
+
+	if( addressFactor != -1.0 )
+		return ( size_t )( hashValue % ( size_t )( addressFactor * array.size( ) ) );
+
+	return ( size_t )( hashValue % array.size( ) );
+}
+
+/* Searches the given key starting at the given
+ * position till the end of probe chain.
+ * Follows the same conventions as coalesced_hashing::findInProbeChain.
+*/
+SearchedResult coalesced_string_hashing::findInProbeChain( string_view key, unsigned long long hashValue, size_t pos ) const {
+
+	/*--- To Store the Search Result. ---*/
+	SearchedResult result;
+	result.probes = 0;
+	result.pos = END_OF_CHAIN;
+	result.length = 0;
+
+	/*--- Nothing in the home address. ---*/
+	if( array[ pos ].status != ACTIVE )
+		return result;
+
+	/*--- Number of probes taken to walk the chain. ---*/
+	size_t probes = 0;
+	size_t prevlink = pos;
+	do {
+
+		probes++;
+
+		/* Compare the stored hash and length first, the key
+		 * bytes are only compared when both of them match.
+		*/
+		const StringHashingEntry & entry = array[ pos ];
+		if( ( entry.status == ACTIVE ) && ( entry.hashValue == hashValue ) &&
+			( entry.length == key.size( ) ) && ( keyAt( pos ) == key ) ) {
+
+			/*--- Item was found. ---*/
+			result.probes = probes;
+			result.length = probes;
+			result.pos = pos;
+			return result;
+		}
+
+		/*--- Set Previous link position. ---*/
+		prevlink = pos;
+
+		/*--- find the next link position. ---*/
+		pos = entry.linkpos;
+
+	} while( pos != END_OF_CHAIN );
+
+	/*--- Not found, return the last item in the probe chain. ---*/
+	result.pos = prevlink;
+	result.length = probes;
+	return result;
+}
+
+/*--- Returns the slot a new record of the given home takes, END_OF_CHAIN when the table is full. ---*/
+size_t coalesced_string_hashing::freeSlot( size_t pos, const SearchedResult & result ) {
+
+	/*--- If there is nothing in the home address. ---*/
+	if( result.pos == END_OF_CHAIN )
+		return pos;
+
+	/*--- Find the bottommost empty location in the table. ---*/
+	while( ( unoccupiedPos != END_OF_CHAIN ) && ( array[ unoccupiedPos ].status == ACTIVE ) )
+		unoccupiedPos--;
+
+	return unoccupiedPos;
+}
+
+/*--- Links the new record at the given slot into the chain of the home address. ---*/
+void coalesced_string_hashing::link( size_t slot, size_t pos, const SearchedResult & result ) {
+
+	/*--- Stored at its home address, it heads the chain. ---*/
+	if( slot == pos )
+		return;
+
+	/* Set the link field of the record at the end of the
+	 * chain to point to the location of the newly inserted record.
+	*/
+	if( !eisch_algorithm )
+		array[ result.pos ].linkpos = slot;
+
+	else {
+
+		/*--- Link the new record right after the home address. ---*/
+		array[ slot ].linkpos = array[ pos ].linkpos;
+		array[ pos ].linkpos = slot;
+	}
+}
+
+/*--- Stores the key into the given slot. ---*/
+void coalesced_string_hashing::store( size_t pos, string_view key, unsigned long long hashValue ) {
+
+	StringHashingEntry & entry = array[ pos ];
+
+	entry.hashValue = hashValue;
+	entry.linkpos = END_OF_CHAIN;
+	entry.length = ( unsigned int ) key.size( );
+	entry.status = ACTIVE;
+
+	/*--- Short keys are kept inside the slot. ---*/
+	if( key.size( ) <= INLINE_KEY_LENGTH )
+		memcpy( entry.bytes, key.data( ), key.size( ) );
+
+	else {
+
+		/*--- Longer keys are appended to the arena. ---*/
+		size_t offset = arena.size( );
+		arena.insert( arena.end( ), key.begin( ), key.end( ) );
+		memcpy( entry.bytes, &offset, sizeof( offset ) );
+	}
+}
+
+/*--- Returns the key stored at the given slot. ---*/
+string_view coalesced_string_hashing::keyAt( size_t pos ) const {
+
+	const StringHashingEntry & entry = array[ pos ];
+
+	if( entry.length <= INLINE_KEY_LENGTH )
+		return string_view( entry.bytes, entry.length );
+
+	size_t offset;
+	memcpy( &offset, entry.bytes, sizeof( offset ) );
+	return string_view( &arena[ offset ], entry.length );
+}
+
+/*--- Marks the given slot empty and available to the insertions. ---*/
+void coalesced_string_hashing::release( size_t pos ) {
+
+	array[ pos ].status = EMPTY;
+	array[ pos ].linkpos = END_OF_CHAIN;
+
+	/*--- The search for an empty slot goes down, so it starts again above the freed slot. ---*/
+	if( ( unoccupiedPos == END_OF_CHAIN ) || ( pos > unoccupiedPos ) )
+		unoccupiedPos = pos;
+}
+
+/*--- Moves the longer keys of the stored records to a new arena, without the removed ones. ---*/
+void coalesced_string_hashing::compact( ) {
+
+	vector< char > compacted;
+	compacted.reserve( arena.size( ) - arenaGarbage );
+
+	for( size_t pos = 0; pos < array.size( ); pos++ ) {
+
+		StringHashingEntry & entry = array[ pos ];
+		if( ( entry.status != ACTIVE ) || ( entry.length <= INLINE_KEY_LENGTH ) )
+			continue;
+
+		size_t offset;
+		memcpy( &offset, entry.bytes, sizeof( offset ) );
+
+		size_t moved = compacted.size( );
+		compacted.insert( compacted.end( ), arena.begin( ) + offset, arena.begin( ) + offset + entry.length );
+		memcpy( entry.bytes, &moved, sizeof( moved ) );
+	}
+
+	arena.swap( compacted );
+	arenaGarbage = 0;
+}
@@ -0,0 +1,194 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __COALESCED_STRING_HASHING_H__
+#define __COALESCED_STRING_HASHING_H__
+
+#include "coalescedhashing.h"
+#include "string_ref.h"
+#include <string_view>
+#include <vector>
+using std::string_view;
+using std::vector;
+
+/**
+ * Coalesced hashing table specialized for string keys.
+ *
+ * => Every slot keeps the full 64-bit hash of its key, so almost
+ *    every probe is resolved by comparing hashes without touching
+ *    the key bytes.
+ *
+ * => Keys of up to INLINE_KEY_LENGTH bytes are stored inside the
+ *    slot, longer keys are appended to a single contiguous arena
+ *    and the slot keeps their offset.
+ *
+ * => Lookups take a string_view, so querying never allocates.
+ *
+ * => A removal inserts again the records that followed the removed
+ *    one in its chain, as coalesced_hashing does.  The arena is
+ *    compacted once the removed keys take half of it.
+ *
+ *    The same four variants as coalesced_hashing are supported:
+ *    LISCH, EISCH, LICH and EICH.
+*/
+
+class coalesced_string_hashing {
+
+	public:
+
+		/*--- Longest key that is stored inside the slot. ---*/
+		static const size_t INLINE_KEY_LENGTH = 11;
+
+		/*--- Longest key the table takes, the slot keeps a 32-bit length. ---*/
+		static const size_t MAX_KEY_LENGTH = 0xFFFFFFFF;
+
+		/*--- Constructor. ---*/
+		coalesced_string_hashing( size_t size, bool eisch );
+
+		/*--- Constructor. ---*/
+		coalesced_string_hashing( size_t size, bool eich, const double & addressFactor );
+
+		/* Insert into the table.  Throws DuplicateItemException, IsFullException,
+		 * or KeyTooLongException for keys longer than MAX_KEY_LENGTH.
+		*/
+		void insert( string_view key );
+
+		/* Insert into the table without throwing, but for keys longer than
+		 * MAX_KEY_LENGTH.  Returns the status together with the slot of the key.
+		*/
+		InsertResult try_insert( string_view key );
+
+		/* Removes the key from the table.  The records that follow it
+		 * in its chain are inserted again, so no chain is left broken.
+		 * Returns 1 when removed and 0 when not stored.
+		*/
+		int remove( string_view key );
+
+		/* Find an item from the table.  Like an iterator, the string_ref
+		 * is only valid until the next insertion, removal or clearing, since
+		 * a growing arena moves the longer keys.
+		*/
+		string_ref find( string_view key ) const;
+
+		/*--- Returns true if the key is stored in the table. ---*/
+		bool contains( string_view key ) const;
+
+		/*--- Empty the table logically. ---*/
+		void clear( );
+
+		/*--- Empties the table physically. ---*/
+		void empty( );
+
+		/*--- Returns the number of items currently within the table. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the size of the table. ---*/
+		size_t size( ) const;
+
+		/*--- Returns the number of bytes used by the key arena. ---*/
+		size_t arenaSize( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Returns the home position for the given hash value. ---*/
+		size_t findPos( unsigned long long hashValue ) const;
+
+		/* Searches the given key starting at the given
+		 * position till the end of probe chain.
+		*/
+		SearchedResult findInProbeChain( string_view key, unsigned long long hashValue, size_t pos ) const;
+
+		/*--- Returns the slot a new record of the given home takes, END_OF_CHAIN when the table is full. ---*/
+		size_t freeSlot( size_t pos, const SearchedResult & result );
+
+		/*--- Links the new record at the given slot into the chain of the home address. ---*/
+		void link( size_t slot, size_t pos, const SearchedResult & result );
+
+		/*--- Stores the key into the given slot. ---*/
+		void store( size_t pos, string_view key, unsigned long long hashValue );
+
+		/*--- Marks the given slot empty and available to the insertions. ---*/
+		void release( size_t pos );
+
+		/*--- Moves the longer keys of the stored records to a new arena, without the removed ones. ---*/
+		void compact( );
+
+		/*--- Returns the key stored at the given slot. ---*/
+		string_view keyAt( size_t pos ) const;
+
+	private: /*--- Private attributes. ---*/
+
+		enum EntryStatus { ACTIVE, REMOVED, EMPTY };
+
+		/* To store the Coalesced Hashing Entry.
+		 * The layout is kept at 32 bytes, two slots per cache line.
+		*/
+		struct StringHashingEntry {
+
+			/*--- Stores the full hash of the key. ---*/
+			unsigned long long hashValue;
+
+			/*--- Link position within chain. ---*/
+			size_t linkpos;
+
+			/*--- Stores the length of the key, at most MAX_KEY_LENGTH. ---*/
+			unsigned int length;
+
+			/*--- Stores the entry status. ---*/
+			unsigned char status;
+
+			/* Stores the key bytes when the key is short,
+			 * otherwise the offset of the key within the arena.
+			*/
+			char bytes[ INLINE_KEY_LENGTH ];
+
+			/*--- Constructor. ---*/
+			StringHashingEntry( ) : hashValue( 0 ), linkpos( END_OF_CHAIN ),
+				length( 0 ), status( EMPTY ) { }
+		};
+
+		/*--- Stores the number of entries currently stored. ---*/
+		size_t occupied;
+
+		/*--- Algorith to use, default is late insertion. ---*/
+		bool eisch_algorithm;
+
+		/*--- Stores the ratio of the primary area to the total table size. ---*/
+		double addressFactor;
+
+		/*--- position to insert the incoming item during insertion. ---*/
+		size_t unoccupiedPos;
+
+		/*--- Array to store the Entries. ---*/
+		vector< StringHashingEntry > array;
+
+		/*--- Contiguous storage for the keys that do not fit in a slot. ---*/
+		vector< char > arena;
+
+		/*--- Bytes of the arena held by removed keys. ---*/
+		size_t arenaGarbage;
+};
+
+#endif
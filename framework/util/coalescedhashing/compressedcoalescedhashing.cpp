@@ -0,0 +1,340 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <type_traits>
+#include "compressedcoalescedhashing.h"
+#include "primes.h"
+#include "exceptions.h"
+
+/*--- Constructor. ---*/
+template < class Key >
+compressed_coalesced_hashing< Key >::compressed_coalesced_hashing( size_t size, bool eisch )
+	: eisch_algorithm( eisch ), slots( nextPrime( size ) ) {
+
+	/*--- The whole table is the address region. ---*/
+	addressSize = slots;
+
+	layout( );
+	clear( );
+}
+
+/*--- Constructor. ---*/
+template < class Key >
+compressed_coalesced_hashing< Key >::compressed_coalesced_hashing( size_t size, bool eich, const double & addressFactor )
+	: eisch_algorithm( eich ), slots( nextPrime( size ) ) {
+
+	/*--- Default in case is less than zero or greater than 1. ---*/
+	double factor = addressFactor;
+	if( ( factor < 0.0 ) || ( factor > 1.0 ) )
+		factor = 0.86;
+
+	/*--- The rest of the table is the cellar. ---*/
+	addressSize = ( size_t )( factor * slots );
+
+	layout( );
+	clear( );
+}
+
+/*--- Insert into the table. ---*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::insert( const Key & key ) {
+
+	/*--- Try to insert the item. ---*/
+	InsertResult result = try_insert( key );
+
+	if( result.status == DUPLICATE ) /*--- Already stored. ---*/
+		throw DuplicateItemException( );
+
+	else if( result.status == FULL ) /*--- No empty location left. ---*/
+		throw IsFullException( );
+}
+
+/* Insert into the table without throwing on a duplicate or full table.
+ * Returns the status together with the slot of the key.
+*/
+template < class Key >
+InsertResult compressed_coalesced_hashing< Key >::try_insert( const Key & key ) {
+
+	unsigned long long value = bits( key );
+	size_t pos = ( size_t )( value % addressSize );
+	unsigned long long quotient = value / addressSize;
+
+	SearchedResult result = findInProbeChain( pos, quotient );
+	if( result.probes > 0 ) { /*--- Already stored. ---*/
+
+		InsertResult duplicate = { DUPLICATE, result.pos };
+		return duplicate;
+	}
+
+	InsertResult inserted = { INSERTED, pos };
+
+	/*--- If there is nothing in the home address, the key starts its chain there. ---*/
+	if( linkOf( pos ) == 0 ) {
+
+		store( pos, quotient, true, pos + 1 );
+
+		occupied++;
+		return inserted;
+	}
+
+	/* Find the bottommost empty location in the table.
+	 * If none is found, report a "full table".
+	*/
+	while( ( unoccupiedPos != END_OF_CHAIN ) && ( linkOf( unoccupiedPos ) != 0 ) )
+		unoccupiedPos--;
+
+	if( unoccupiedPos == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	/*--- A record displaced into the home address moves out of the way. ---*/
+	if( result.pos == END_OF_CHAIN ) {
+
+		relocate( pos, unoccupiedPos );
+		store( pos, quotient, true, pos + 1 );
+
+		occupied++;
+		return inserted;
+	}
+
+	if( !eisch_algorithm ) {
+
+		/*--- Link it at the end of the chain, it links back to the home address. ---*/
+		store( unoccupiedPos, quotient, false, pos + 1 );
+		setLink( result.pos, unoccupiedPos + 1 );
+	}
+
+	else {
+
+		/*--- Link it right after the home address. ---*/
+		store( unoccupiedPos, quotient, false, linkOf( pos ) );
+		setLink( pos, unoccupiedPos + 1 );
+	}
+
+	occupied++;
+
+	inserted.pos = unoccupiedPos;
+	return inserted;
+}
+
+/* Searches the key.  The probes are zero when it is not stored,
+ * otherwise pos is the slot of the key.
+*/
+template < class Key >
+SearchedResult compressed_coalesced_hashing< Key >::search( const Key & key ) const {
+
+	unsigned long long value = bits( key );
+
+	return findInProbeChain( ( size_t )( value % addressSize ), value / addressSize );
+}
+
+/*--- Returns true if the key is stored in the table. ---*/
+template < class Key >
+bool compressed_coalesced_hashing< Key >::contains( const Key & key ) const {
+
+	return search( key ).probes > 0;
+}
+
+/*--- Returns true if the given slot holds a key. ---*/
+template < class Key >
+bool compressed_coalesced_hashing< Key >::isOccupied( size_t pos ) const {
+
+	return linkOf( pos ) != 0;
+}
+
+/*--- Returns the key stored at the given slot, rebuilt from its quotient. ---*/
+template < class Key >
+Key compressed_coalesced_hashing< Key >::keyAt( size_t pos ) const {
+
+	/*--- The last record of a chain links back to its home address. ---*/
+	size_t home = pos;
+	while( !isHome( home ) )
+		home = linkOf( home ) - 1;
+
+	unsigned long long value = quotientOf( pos ) * addressSize + home;
+
+	return ( Key )( typename std::make_unsigned< Key >::type )value;
+}
+
+/*--- Empty the table logically. ---*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::clear( ) {
+
+	occupied = 0;
+
+	/*--- Table Size - 1. ---*/
+	unoccupiedPos = slots - 1;
+
+	/*--- Make the positions logically empty. ---*/
+	entries.clear( );
+}
+
+/*--- Returns the number of items currently within the table. ---*/
+template < class Key >
+size_t compressed_coalesced_hashing< Key >::elements( ) const {
+
+	return occupied;
+}
+
+/*--- Returns the size of the table. ---*/
+template < class Key >
+size_t compressed_coalesced_hashing< Key >::size( ) const {
+
+	return slots;
+}
+
+/*--- Returns the number of bytes used by the slots of the table. ---*/
+template < class Key >
+size_t compressed_coalesced_hashing< Key >::memory( ) const {
+
+	return entries.memory( );
+}
+
+/*--- Returns the number of bits taken by a slot. ---*/
+template < class Key >
+size_t compressed_coalesced_hashing< Key >::slotBits( ) const {
+
+	return entryBits;
+}
+
+/*--- Sizes the fields of a slot for the table and allocates the slots. ---*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::layout( ) {
+
+	/*--- The largest key decides the width of the quotient. ---*/
+	unsigned long long largest = bits( ( Key )~( typename std::make_unsigned< Key >::type )0 );
+
+	quotientBits = packed_bits::bitWidth( largest / addressSize );
+	linkBits = packed_bits::bitWidth( slots );
+	entryBits = linkBits + 1 + quotientBits;
+
+	entries.assign( slots * entryBits );
+}
+
+/*--- Returns the bits of the key as an unsigned number. ---*/
+template < class Key >
+unsigned long long compressed_coalesced_hashing< Key >::bits( const Key & key ) {
+
+	return ( unsigned long long )( typename std::make_unsigned< Key >::type )key;
+}
+
+/* Searches the key of the given home address and quotient till the end
+ * of the probe chain.  When it is not found, pos is the last slot of the
+ * chain, or END_OF_CHAIN when the home address holds no record of its own.
+*/
+template < class Key >
+SearchedResult compressed_coalesced_hashing< Key >::findInProbeChain( size_t home, unsigned long long quotient ) const {
+
+	SearchedResult result = { 0, END_OF_CHAIN, 1 };
+
+	/*--- Only a record at its home address starts a chain. ---*/
+	if( !isHome( home ) )
+		return result;
+
+	size_t pos = home;
+	for( size_t visited = 1; ; visited++ ) {
+
+		/*--- Every record of the chain has the same home address. ---*/
+		if( quotientOf( pos ) == quotient ) {
+
+			result.probes = visited;
+			result.pos = pos;
+			result.length = visited;
+			return result;
+		}
+
+		result.length = visited;
+
+		/*--- Stop once the chain links back to its home address. ---*/
+		size_t next = linkOf( pos ) - 1;
+		if( next == home )
+			break;
+
+		pos = next;
+	}
+
+	/*--- Not found, the position is the last element within the probe chain. ---*/
+	result.pos = pos;
+	return result;
+}
+
+/* Moves the displaced record at the given slot to the empty slot
+ * to, linking the copy in before the slot is overwritten.
+*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::relocate( size_t pos, size_t to ) {
+
+	/*--- The home address of the record is where its chain links back to. ---*/
+	size_t home = linkOf( pos ) - 1;
+	while( !isHome( home ) )
+		home = linkOf( home ) - 1;
+
+	/*--- Find the record linking to it. ---*/
+	size_t before = home;
+	while( linkOf( before ) - 1 != pos )
+		before = linkOf( before ) - 1;
+
+	store( to, quotientOf( pos ), false, linkOf( pos ) );
+	setLink( before, to + 1 );
+}
+
+/*--- Returns the link of the given slot, the next position plus one, zero when it is empty. ---*/
+template < class Key >
+size_t compressed_coalesced_hashing< Key >::linkOf( size_t pos ) const {
+
+	return ( size_t )entries.read( pos * entryBits, linkBits );
+}
+
+/*--- Returns true if the given slot holds a record at its home address. ---*/
+template < class Key >
+bool compressed_coalesced_hashing< Key >::isHome( size_t pos ) const {
+
+	return entries.read( pos * entryBits + linkBits, 1 ) != 0;
+}
+
+/*--- Returns the quotient stored at the given slot. ---*/
+template < class Key >
+unsigned long long compressed_coalesced_hashing< Key >::quotientOf( size_t pos ) const {
+
+	return entries.read( pos * entryBits + linkBits + 1, quotientBits );
+}
+
+/*--- Writes every field of the given slot. ---*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::store( size_t pos, unsigned long long quotient, bool home, size_t link ) {
+
+	entries.write( pos * entryBits, linkBits, link );
+	entries.write( pos * entryBits + linkBits, 1, home ? 1 : 0 );
+	entries.write( pos * entryBits + linkBits + 1, quotientBits, quotient );
+}
+
+/*--- Writes the link of the given slot. ---*/
+template < class Key >
+void compressed_coalesced_hashing< Key >::setLink( size_t pos, size_t link ) {
+
+	entries.write( pos * entryBits, linkBits, link );
+}
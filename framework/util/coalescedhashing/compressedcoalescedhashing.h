@@ -0,0 +1,159 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __COMPRESSED_COALESCED_HASHING_H__
+#define __COMPRESSED_COALESCED_HASHING_H__
+
+#include "coalescedhashing.h"
+#include "packedbits.h"
+
+/**
+ * Coalesced hashing of integer keys which stores quotients instead of
+ * the keys.
+ *
+ * => The home address of a key is key % addressSize, so a slot only
+ *    stores the quotient key / addressSize, in the bits it can take
+ *    for the width of the key, a home flag and a link just wide enough
+ *    for the size of the table.  The slots are packed next to each
+ *    other in 64-bit words, so every key fits and a slot of a table of
+ *    13093 slots and 32-bit keys takes 34 bits.
+ *
+ * => The home flag marks a record stored at its home address.  Such a
+ *    record heads the chain of the other records of its home address,
+ *    and the last of them links back to it, so the home of any record
+ *    is found by following its chain.  A record found at the home
+ *    address of a new key was displaced there by another chain, and
+ *    is moved to an empty slot first, so chains never coalesce.
+ *
+ * => Insertions take the empty slots from the bottom of the table, the
+ *    cellar first for EICH and LICH, and link the record right after
+ *    its home address for early insertion or at the end of the chain
+ *    for late insertion.  Keys are rebuilt from their slot.
+*/
+
+template < class Key >
+class compressed_coalesced_hashing {
+
+	public:
+
+		/*--- Constructor. ---*/
+		compressed_coalesced_hashing( size_t size, bool eisch );
+
+		/*--- Constructor. ---*/
+		compressed_coalesced_hashing( size_t size, bool eich, const double & addressFactor );
+
+		/*--- Insert into the table. ---*/
+		void insert( const Key & key );
+
+		/* Insert into the table without throwing on a duplicate or full table.
+		 * Returns the status together with the slot of the key.
+		*/
+		InsertResult try_insert( const Key & key );
+
+		/* Searches the key.  The probes are zero when it is not stored,
+		 * otherwise pos is the slot of the key.
+		*/
+		SearchedResult search( const Key & key ) const;
+
+		/*--- Returns true if the key is stored in the table. ---*/
+		bool contains( const Key & key ) const;
+
+		/*--- Returns true if the given slot holds a key. ---*/
+		bool isOccupied( size_t pos ) const;
+
+		/*--- Returns the key stored at the given slot, rebuilt from its quotient. ---*/
+		Key keyAt( size_t pos ) const;
+
+		/*--- Empty the table logically. ---*/
+		void clear( );
+
+		/*--- Returns the number of items currently within the table. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the size of the table. ---*/
+		size_t size( ) const;
+
+		/*--- Returns the number of bytes used by the slots of the table. ---*/
+		size_t memory( ) const;
+
+		/*--- Returns the number of bits taken by a slot. ---*/
+		size_t slotBits( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Sizes the fields of a slot for the table and allocates the slots. ---*/
+		void layout( );
+
+		/*--- Returns the bits of the key as an unsigned number. ---*/
+		static unsigned long long bits( const Key & key );
+
+		/*--- Searches the key of the given home address and quotient till the end of the probe chain. ---*/
+		SearchedResult findInProbeChain( size_t home, unsigned long long quotient ) const;
+
+		/* Moves the displaced record at the given slot to the empty slot
+		 * to, linking the copy in before the slot is overwritten.
+		*/
+		void relocate( size_t pos, size_t to );
+
+		/*--- Returns the link of the given slot, the next position plus one, zero when it is empty. ---*/
+		size_t linkOf( size_t pos ) const;
+
+		/*--- Returns true if the given slot holds a record at its home address. ---*/
+		bool isHome( size_t pos ) const;
+
+		/*--- Returns the quotient stored at the given slot. ---*/
+		unsigned long long quotientOf( size_t pos ) const;
+
+		/*--- Writes every field of the given slot. ---*/
+		void store( size_t pos, unsigned long long quotient, bool home, size_t link );
+
+		/*--- Writes the link of the given slot. ---*/
+		void setLink( size_t pos, size_t link );
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- Stores the number of entries currently stored. ---*/
+		size_t occupied;
+
+		/*--- Algorith to use, default is late insertion. ---*/
+		bool eisch_algorithm;
+
+		/*--- Number of slots of the table. ---*/
+		size_t slots;
+
+		/*--- Number of slots that can be a home address. ---*/
+		size_t addressSize;
+
+		/*--- Width of the link, of the quotient and of a whole slot, in bits. ---*/
+		size_t linkBits, quotientBits, entryBits;
+
+		/*--- position to insert the incoming item during insertion. ---*/
+		size_t unoccupiedPos;
+
+		/*--- Stores the slots, packed one after the other. ---*/
+		packed_bits entries;
+};
+
+#endif
@@ -45,7 +45,7 @@ const_ref< Object >::const_ref( )
 
 /*--- Constructor that takes in a reference to a constant object. ---*/
 template< class Object >
-const_ref< Object >::const_ref( const Object & obj, size_t linkpos, int probes ) {
+const_ref< Object >::const_ref( const Object & obj, size_t linkpos, size_t probes ) {
 
 	/*--- Set the object ---*/
 	object = &obj;
@@ -71,7 +71,7 @@ const Object& const_ref< Object >::getObject( ) const {
 
 /*--- Returns the number of probes. ---*/
 template< class Object >
-int const_ref< Object >::getProbes( ) const {
+size_t const_ref< Object >::getProbes( ) const {
 
 	return probes;
 }
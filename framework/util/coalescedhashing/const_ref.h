@@ -45,13 +45,13 @@ class const_ref {
 		const_ref( );
 
 		/*--- Constructor that takes in a reference to a constant object. ---*/
-		const_ref( const Object & obj, size_t linkpos, int probes );
+		const_ref( const Object & obj, size_t linkpos, size_t probes );
 
 		/*--- Returns the Object. ---*/
 		const Object & getObject( ) const;
 
 		/*--- Returns the number of probes. ---*/
-		int getProbes( ) const;
+		size_t getProbes( ) const;
 
 		/*--- Returns the link position. ---*/
 		size_t getLinkPos( ) const;
@@ -68,7 +68,7 @@ class const_ref {
 		const Object * object;
 
 		/*--- Stores the number probes. ---*/
-		int probes;
+		size_t probes;
 
 		/*--- Stores the link position. ---*/
 		size_t linkpos;
@@ -0,0 +1,713 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <string.h>
+#include <thread>
+#include <type_traits>
+#include "durablecoalescedhashing.h"
+#include "exceptions.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define DURABLE_FILES_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#endif
+
+/*--- Marks a complete checkpoint file. ---*/
+#define CHECKPOINT_MAGIC 0x434f414c43484b50ULL
+
+/*--- Logs smaller than this are not worth a thread per home range. ---*/
+#define REPLAY_MINIMUM_PER_THREAD 16384
+
+/*--- Operations of the log. ---*/
+#define LOG_INSERT 'I'
+#define LOG_REMOVE 'R'
+
+/*--- Leads the checkpoint file, the table it was taken from must have the same geometry. ---*/
+struct CheckpointHeader {
+
+	unsigned long long magic;
+	unsigned long long objectBytes;
+	unsigned long long slots;
+	unsigned long long addressSize;
+	unsigned long long records;
+	unsigned long long eisch;
+};
+
+/*--- FNV-1a of the bytes, 32 bits for a log record. ---*/
+static unsigned int recordChecksum( const unsigned char * bytes, size_t length ) {
+
+	unsigned int hash = 2166136261U;
+	for( size_t i = 0; i < length; i++ )
+		hash = ( hash ^ bytes[ i ] ) * 16777619U;
+
+	return hash;
+}
+
+/*--- FNV-1a of the bytes, 64 bits carried across the records of a checkpoint. ---*/
+static unsigned long long checkpointChecksum( unsigned long long hash, const void * data, size_t length ) {
+
+	const unsigned char * bytes = ( const unsigned char * )data;
+	for( size_t i = 0; i < length; i++ )
+		hash = ( hash ^ bytes[ i ] ) * 1099511628211ULL;
+
+	return hash;
+}
+
+/*--- Forces the written data of the file to the disk. ---*/
+static bool syncFile( FILE * file ) {
+
+	if( fflush( file ) != 0 )
+		return false;
+
+#if defined( DURABLE_FILES_POSIX )
+	return fsync( fileno( file ) ) == 0;
+#elif defined( _WIN32 )
+	return _commit( _fileno( file ) ) == 0;
+#else
+	return true;
+#endif
+}
+
+/*--- Forces the entries of the directory to the disk, so that created and renamed files stay. ---*/
+static bool syncDirectory( const std::string & directory ) {
+
+#if defined( DURABLE_FILES_POSIX )
+	int descriptor = open( directory.c_str( ), O_RDONLY );
+	if( descriptor < 0 )
+		return false;
+
+	bool synced = ( fsync( descriptor ) == 0 );
+	close( descriptor );
+	return synced;
+#else
+	( void )directory;
+	return true;
+#endif
+}
+
+/*--- Replaces the target with the source, and makes the rename itself durable. ---*/
+static bool replaceFile( const std::string & source, const std::string & target, const std::string & directory ) {
+
+#if defined( DURABLE_FILES_POSIX )
+	if( rename( source.c_str( ), target.c_str( ) ) != 0 )
+		return false;
+
+	/*--- The rename is only durable once its directory is synced. ---*/
+	return syncDirectory( directory );
+#elif defined( _WIN32 )
+	( void )directory;
+	return MoveFileExA( source.c_str( ), target.c_str( ), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+#else
+	( void )directory;
+	remove( target.c_str( ) );
+	return rename( source.c_str( ), target.c_str( ) ) == 0;
+#endif
+}
+
+/*--- Returns the number of threads to replay the given number of records with. ---*/
+static size_t replayThreads( size_t records ) {
+
+	size_t threads = std::thread::hardware_concurrency( );
+
+	if( threads > records / REPLAY_MINIMUM_PER_THREAD )
+		threads = records / REPLAY_MINIMUM_PER_THREAD;
+
+	return ( threads < 1 ) ? 1 : threads;
+}
+
+/* Checks the records of the given slice of the log, and hands out the
+ * valid ones by the home range of their object.  Stops at the first
+ * record whose checksum does not match, and leaves its index in invalid.
+*/
+template < class Object >
+void durable_coalesced_hashing< Object >::partitionLog( const coalesced_hashing< Object > & table, const vector< unsigned char > & log,
+	size_t begin, size_t end, size_t threads, vector< vector< size_t > > & ranges, size_t & invalid ) {
+
+	const size_t recordBytes = 1 + sizeof( Object ) + sizeof( unsigned int );
+
+	for( size_t record = begin; record < end; record++ ) {
+
+		const unsigned char * bytes = &log[ record * recordBytes ];
+
+		unsigned int checksum;
+		memcpy( &checksum, bytes + 1 + sizeof( Object ), sizeof( checksum ) );
+
+		if( ( ( bytes[ 0 ] != LOG_INSERT ) && ( bytes[ 0 ] != LOG_REMOVE ) ) ||
+			( recordChecksum( bytes, 1 + sizeof( Object ) ) != checksum ) ) {
+
+			invalid = record;
+			return;
+		}
+
+		Object object;
+		memcpy( &object, bytes + 1, sizeof( Object ) );
+		/*--- Home addresses lie below addressSize, the cellar is no one's range. ---*/
+		size_t range = table.findPos( object ) * threads / table.addressSize;
+		ranges[ ( range < threads ) ? range : threads - 1 ].push_back( record );
+	}
+}
+
+/* Reduces the records of one home range, in log order, to the last
+ * operation on every object.  Records from the first invalid one on
+ * are ignored.
+*/
+template < class Object >
+void durable_coalesced_hashing< Object >::reduceRange( const vector< unsigned char > & log, const vector< vector< vector< size_t > > > & partitions,
+	size_t range, size_t valid, vector< Object > & removals, vector< Object > & insertions ) {
+
+	const size_t recordBytes = 1 + sizeof( Object ) + sizeof( unsigned int );
+
+	size_t records = 0;
+	for( size_t slice = 0; slice < partitions.size( ); slice++ )
+		records += partitions[ slice ][ range ].size( );
+
+	coalesced_hashing< Object > inserted( records + 1, true );
+	coalesced_hashing< Object > removed( records + 1, true );
+
+	/*--- The slices are consecutive parts of the log, so their order is the log order. ---*/
+	for( size_t slice = 0; slice < partitions.size( ); slice++ ) {
+
+		const vector< size_t > & part = partitions[ slice ][ range ];
+		for( size_t i = 0; ( i < part.size( ) ) && ( part[ i ] < valid ); i++ ) {
+
+			const unsigned char * bytes = &log[ part[ i ] * recordBytes ];
+
+			Object object;
+			memcpy( &object, bytes + 1, sizeof( Object ) );
+
+			if( bytes[ 0 ] == LOG_INSERT ) {
+
+				removed.remove( object );
+				inserted.try_insert( object );
+			}
+			else {
+
+				inserted.remove( object );
+				removed.try_insert( object );
+			}
+		}
+	}
+
+	for( size_t pos = 0; pos < removed.size( ); pos++ )
+		if( removed.isOccupied( pos ) )
+			removals.push_back( removed.objectAt( pos ) );
+
+	for( size_t pos = 0; pos < inserted.size( ); pos++ )
+		if( inserted.isOccupied( pos ) )
+			insertions.push_back( inserted.objectAt( pos ) );
+}
+
+/*--- Opens or creates the table in the given directory, the whole table is the address region. ---*/
+template < class Object >
+durable_coalesced_hashing< Object >::durable_coalesced_hashing( const char * directory, size_t size, bool eisch )
+	: hashing( size, eisch ) {
+
+	static_assert( std::is_trivially_copyable< Object >::value, "durable tables log their objects byte by byte" );
+
+	directoryPath = directory;
+	checkpointPath = directoryPath + "/coalesced.checkpoint";
+	logPath = directoryPath + "/coalesced.log";
+	previousLogPath = logPath + ".previous";
+
+	syncEvery = 64;
+	checkpointEvery = 0;
+	checkpointRunning = false;
+	checkpointFailed = false;
+	open( );
+}
+
+/*--- Opens or creates the table in the given directory, the rest of the address region is the cellar. ---*/
+template < class Object >
+durable_coalesced_hashing< Object >::durable_coalesced_hashing( const char * directory, size_t size, bool eich,
+	const double & addressFactor ) : hashing( size, eich, addressFactor ) {
+
+	static_assert( std::is_trivially_copyable< Object >::value, "durable tables log their objects byte by byte" );
+
+	directoryPath = directory;
+	checkpointPath = directoryPath + "/coalesced.checkpoint";
+	logPath = directoryPath + "/coalesced.log";
+	previousLogPath = logPath + ".previous";
+
+	syncEvery = 64;
+	checkpointEvery = 0;
+	checkpointRunning = false;
+	checkpointFailed = false;
+	open( );
+}
+
+/*--- Syncs the operations still buffered and closes the log. ---*/
+template < class Object >
+durable_coalesced_hashing< Object >::~durable_coalesced_hashing( ) {
+
+	/*--- Whatever could not be synced is lost, as in a crash. ---*/
+	try {
+
+		if( checkpointer.joinable( ) )
+			finishCheckpoint( );
+
+		sync( );
+	}
+	catch( const DurabilityException & ) { }
+
+	if( log != NULL )
+		fclose( log );
+}
+
+/*--- Insert into the table. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::insert( const Object & object ) {
+
+	hashing.insert( object );
+	append( LOG_INSERT, object );
+}
+
+/* Insert into the table without throwing on a duplicate or full
+ * table.  Only insertions are logged.
+*/
+template < class Object >
+InsertResult durable_coalesced_hashing< Object >::try_insert( const Object & object ) {
+
+	InsertResult result = hashing.try_insert( object );
+
+	if( result.status == INSERTED )
+		append( LOG_INSERT, object );
+
+	return result;
+}
+
+/*--- Removes the item from the table, returns 1 when removed and 0 when not stored. ---*/
+template < class Object >
+int durable_coalesced_hashing< Object >::remove( const Object & object ) {
+
+	int removed = hashing.remove( object );
+
+	if( removed == 1 )
+		append( LOG_REMOVE, object );
+
+	return removed;
+}
+
+/*--- Find an item from the table. ---*/
+template < class Object >
+const_ref< Object > durable_coalesced_hashing< Object >::find( const Object & object ) const {
+
+	return hashing.find( object );
+}
+
+/*--- Returns true if the item is stored in the table. ---*/
+template < class Object >
+bool durable_coalesced_hashing< Object >::contains( const Object & object ) const {
+
+	return hashing.contains( object );
+}
+
+/* Find an item from the table without throwing.
+ * Returns NULL when the item is not stored.
+*/
+template < class Object >
+const Object * durable_coalesced_hashing< Object >::try_find( const Object & object ) const {
+
+	return hashing.try_find( object );
+}
+
+/*--- Sets the number of operations committed by one sync, 64 by default. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::setSyncInterval( size_t operations ) {
+
+	syncEvery = operations;
+
+	if( pendingOperations >= syncEvery )
+		sync( );
+}
+
+/*--- Sets the number of operations between checkpoints, zero to take them only on request. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::setCheckpointInterval( size_t operations ) {
+
+	checkpointEvery = operations;
+}
+
+/*--- Writes the buffered operations to the log and syncs it. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::sync( ) {
+
+	if( pending.empty( ) )
+		return;
+
+	/*--- The log could not be opened again after the last checkpoint. ---*/
+	if( log == NULL )
+		throw DurabilityException( );
+
+	/*--- One write and one sync commit the whole group. ---*/
+	if( ( fwrite( &pending[ 0 ], 1, pending.size( ), log ) != pending.size( ) ) || !syncFile( log ) )
+		throw DurabilityException( );
+
+	pending.clear( );
+	pendingOperations = 0;
+}
+
+/*--- Writes a checkpoint of the slots and empties the log. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::checkpoint( ) {
+
+	if( checkpointer.joinable( ) )
+		finishCheckpoint( );
+
+	startCheckpoint( );
+	finishCheckpoint( );
+}
+
+/* Syncs the log and moves it aside, then starts writing a checkpoint
+ * of a snapshot of the table from a background thread.
+*/
+template < class Object >
+void durable_coalesced_hashing< Object >::startCheckpoint( ) {
+
+	/*--- A log left aside by a failed checkpoint holds operations no checkpoint has. ---*/
+	FILE * previous = fopen( previousLogPath.c_str( ), "rb" );
+	if( previous != NULL ) {
+
+		fclose( previous );
+		throw DurabilityException( );
+	}
+
+	/*--- The moved log holds every operation up to the snapshot. ---*/
+	sync( );
+
+	if( log != NULL )
+		fclose( log );
+
+	log = NULL;
+	if( !replaceFile( logPath, previousLogPath, directoryPath ) )
+		throw DurabilityException( );
+
+	log = fopen( logPath.c_str( ), "wb" );
+	if( ( log == NULL ) || !syncFile( log ) || !syncDirectory( directoryPath ) )
+		throw DurabilityException( );
+
+	sinceCheckpoint = 0;
+	checkpointRunning = true;
+	checkpointFailed = false;
+	checkpointer = std::thread( writeCheckpoint, hashing.snapshot( ), ( size_t )hashing.addressSize, hashing.eisch_algorithm,
+		checkpointPath, previousLogPath, directoryPath, &checkpointRunning, &checkpointFailed );
+}
+
+/*--- Waits for the background checkpoint, throws DurabilityException when it failed. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::finishCheckpoint( ) {
+
+	checkpointer.join( );
+
+	if( checkpointFailed )
+		throw DurabilityException( );
+}
+
+/* Writes the checkpoint of the snapshot, and deletes the moved log once
+ * it is in place.  Runs on its own thread, and touches the snapshot only.
+*/
+template < class Object >
+void durable_coalesced_hashing< Object >::writeCheckpoint( coalesced_snapshot< Object > view, size_t addressSize, bool eisch,
+	std::string checkpointPath, std::string previousLogPath, std::string directoryPath,
+	std::atomic< bool > * running, bool * failed ) {
+
+	std::string temporary = checkpointPath + ".tmp";
+	FILE * file = fopen( temporary.c_str( ), "wb" );
+
+	CheckpointHeader header;
+	header.magic = CHECKPOINT_MAGIC;
+	header.objectBytes = sizeof( Object );
+	header.slots = view.size( );
+	header.addressSize = addressSize;
+	header.records = view.elements( );
+	header.eisch = eisch ? 1 : 0;
+
+	bool written = ( file != NULL ) && ( fwrite( &header, sizeof( header ), 1, file ) == 1 );
+
+	/*--- The occupied slots with their links, so they are put back without hashing. ---*/
+	unsigned long long checksum = 14695981039346656037ULL;
+	for( size_t pos = 0; written && ( pos < view.size( ) ); pos++ ) {
+
+		if( !view.isOccupied( pos ) )
+			continue;
+
+		unsigned long long slot[ 2 ] = { pos, view.linkAt( pos ) };
+		checksum = checkpointChecksum( checksum, slot, sizeof( slot ) );
+		checksum = checkpointChecksum( checksum, &view.objectAt( pos ), sizeof( Object ) );
+
+		written = ( fwrite( slot, sizeof( slot ), 1, file ) == 1 ) &&
+			( fwrite( &view.objectAt( pos ), sizeof( Object ), 1, file ) == 1 );
+	}
+
+	written = written && ( fwrite( &checksum, sizeof( checksum ), 1, file ) == 1 ) && syncFile( file );
+	if( file != NULL )
+		fclose( file );
+
+	/* The moved log is in the checkpoint now.  Replaying it over the new
+	 * checkpoint after a crash right before it is deleted gives the same
+	 * table, the last operation of every object is already in it.
+	*/
+	written = written && replaceFile( temporary, checkpointPath, directoryPath ) &&
+		( ::remove( previousLogPath.c_str( ) ) == 0 ) && syncDirectory( directoryPath );
+
+	*failed = !written;
+	running->store( false );
+}
+
+/*--- Returns the number of logged operations replayed when the table was opened. ---*/
+template < class Object >
+size_t durable_coalesced_hashing< Object >::replayedOperations( ) const {
+
+	return replayed;
+}
+
+/*--- Returns the table in memory. ---*/
+template < class Object >
+const coalesced_hashing< Object > & durable_coalesced_hashing< Object >::table( ) const {
+
+	return hashing;
+}
+
+/*--- Returns the number of items currently within the table. ---*/
+template < class Object >
+size_t durable_coalesced_hashing< Object >::elements( ) const {
+
+	return hashing.elements( );
+}
+
+/*--- Returns the size of the table. ---*/
+template < class Object >
+size_t durable_coalesced_hashing< Object >::size( ) const {
+
+	return hashing.size( );
+}
+
+/*--- Loads the checkpoint and replays the log, then opens the log for appending. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::open( ) {
+
+	pendingOperations = 0;
+	sinceCheckpoint = 0;
+	replayed = 0;
+
+	loadCheckpoint( );
+	replayLog( );
+
+	log = fopen( logPath.c_str( ), "ab" );
+	if( log == NULL )
+		throw DurabilityException( );
+}
+
+/*--- Puts back the slots of the checkpoint, returns false when there is none. ---*/
+template < class Object >
+bool durable_coalesced_hashing< Object >::loadCheckpoint( ) {
+
+	FILE * file = fopen( checkpointPath.c_str( ), "rb" );
+	if( file == NULL )
+		return false;
+
+	CheckpointHeader header;
+	bool valid = ( fread( &header, sizeof( header ), 1, file ) == 1 ) &&
+		( header.magic == CHECKPOINT_MAGIC ) && ( header.objectBytes == sizeof( Object ) ) &&
+		( header.slots == hashing.size( ) ) && ( header.addressSize == hashing.addressSize ) &&
+		( header.eisch == ( hashing.eisch_algorithm ? 1U : 0U ) ) && ( header.records <= header.slots );
+
+	typedef typename coalesced_hashing< Object >::CoalescedHashingEntry Entry;
+
+	hashing.clear( );
+
+	unsigned long long checksum = 14695981039346656037ULL;
+	for( unsigned long long record = 0; valid && ( record < header.records ); record++ ) {
+
+		unsigned long long slot[ 2 ];
+		Object object;
+
+		valid = ( fread( slot, sizeof( slot ), 1, file ) == 1 ) && ( fread( &object, sizeof( Object ), 1, file ) == 1 ) &&
+			( slot[ 0 ] < header.slots ) && ( ( slot[ 1 ] < header.slots ) || ( slot[ 1 ] == END_OF_CHAIN ) );
+
+		if( valid ) {
+
+			checksum = checkpointChecksum( checksum, slot, sizeof( slot ) );
+			checksum = checkpointChecksum( checksum, &object, sizeof( Object ) );
+			hashing.array.write( ( size_t )slot[ 0 ] ) = Entry( object, ( size_t )slot[ 1 ], coalesced_hashing< Object >::ACTIVE );
+		}
+	}
+
+	unsigned long long stored;
+	valid = valid && ( fread( &stored, sizeof( stored ), 1, file ) == 1 ) && ( stored == checksum );
+	fclose( file );
+
+	/*--- The checkpoint is replaced whole, a damaged one is not a crash to recover from. ---*/
+	if( !valid ) {
+
+		hashing.clear( );
+		throw DurabilityException( );
+	}
+
+	hashing.occupied = ( size_t )header.records;
+	return true;
+}
+
+/*--- Replays the log over the table, and drops a torn record at its end. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::replayLog( ) {
+
+	/* The log moved aside by a checkpoint that did not finish comes first,
+	 * its operations are older than those of the log.
+	*/
+	vector< unsigned char > bytes;
+	unsigned char buffer[ 65536 ];
+	bool previous = false;
+	FILE * file = NULL;
+	for( int part = 0; part < 2; part++ ) {
+
+		file = fopen( ( ( part == 0 ) ? previousLogPath : logPath ).c_str( ), "rb" );
+		if( file == NULL )
+			continue;
+
+		previous = previous || ( part == 0 );
+		for( size_t read; ( read = fread( buffer, 1, sizeof( buffer ), file ) ) > 0; )
+			bytes.insert( bytes.end( ), buffer, buffer + read );
+		fclose( file );
+	}
+
+	const size_t recordBytes = 1 + sizeof( Object ) + sizeof( unsigned int );
+	size_t records = bytes.size( ) / recordBytes;
+	size_t threads = replayThreads( records );
+
+	/*--- Every thread checks a slice of the log and hands its records out by home range. ---*/
+	vector< vector< vector< size_t > > > partitions( threads, vector< vector< size_t > >( threads ) );
+	vector< size_t > invalid( threads, records );
+	size_t share = ( records + threads - 1 ) / threads;
+
+	if( threads == 1 )
+		partitionLog( hashing, bytes, 0, records, 1, partitions[ 0 ], invalid[ 0 ] );
+
+	else {
+
+		vector< std::thread > workers;
+		for( size_t t = 0; t < threads; t++ ) {
+
+			size_t begin = ( t * share < records ) ? t * share : records;
+			size_t end = ( begin + share < records ) ? begin + share : records;
+			workers.push_back( std::thread( partitionLog, std::cref( hashing ), std::cref( bytes ), begin, end,
+				threads, std::ref( partitions[ t ] ), std::ref( invalid[ t ] ) ) );
+		}
+
+		for( size_t t = 0; t < threads; t++ )
+			workers[ t ].join( );
+	}
+
+	/*--- The log is valid up to its first damaged record. ---*/
+	size_t valid = records;
+	for( size_t t = 0; t < threads; t++ )
+		if( invalid[ t ] < valid )
+			valid = invalid[ t ];
+
+	/*--- Every thread reduces one home range to the last operation on each object. ---*/
+	vector< vector< Object > > removals( threads ), insertions( threads );
+
+	if( threads == 1 )
+		reduceRange( bytes, partitions, 0, valid, removals[ 0 ], insertions[ 0 ] );
+
+	else {
+
+		vector< std::thread > workers;
+		for( size_t t = 0; t < threads; t++ )
+			workers.push_back( std::thread( reduceRange, std::cref( bytes ), std::cref( partitions ), t, valid,
+				std::ref( removals[ t ] ), std::ref( insertions[ t ] ) ) );
+
+		for( size_t t = 0; t < threads; t++ )
+			workers[ t ].join( );
+	}
+
+	/* Chains cross the home ranges, so the net operations are applied by
+	 * one thread, the removals first to free the slots the insertions take.
+	 * Objects already in or out of the checkpoint are skipped.
+	*/
+	for( size_t t = 0; t < threads; t++ )
+		for( size_t i = 0; i < removals[ t ].size( ); i++ )
+			hashing.remove( removals[ t ][ i ] );
+
+	for( size_t t = 0; t < threads; t++ )
+		for( size_t i = 0; i < insertions[ t ].size( ); i++ )
+			if( hashing.try_insert( insertions[ t ][ i ] ).status == FULL )
+				throw DurabilityException( );
+
+	replayed = valid;
+	sinceCheckpoint = valid;
+
+	/* Drop the torn tail, so new records follow the last valid one, and
+	 * take the moved log into the log.  Replaying the moved log again over
+	 * the log holding it, after a crash right before it is deleted, gives
+	 * the same table.
+	*/
+	if( previous || ( valid * recordBytes < bytes.size( ) ) ) {
+
+		std::string temporary = logPath + ".tmp";
+		file = fopen( temporary.c_str( ), "wb" );
+		bool written = ( file != NULL ) &&
+			( ( valid == 0 ) || ( fwrite( &bytes[ 0 ], recordBytes, valid, file ) == valid ) ) && syncFile( file );
+
+		if( file != NULL )
+			fclose( file );
+
+		if( !written || !replaceFile( temporary, logPath, directoryPath ) ||
+			( previous && ( ( ::remove( previousLogPath.c_str( ) ) != 0 ) || !syncDirectory( directoryPath ) ) ) )
+			throw DurabilityException( );
+	}
+}
+
+/*--- Buffers an operation, and commits the group once it is full. ---*/
+template < class Object >
+void durable_coalesced_hashing< Object >::append( unsigned char operation, const Object & object ) {
+
+	unsigned char record[ 1 + sizeof( Object ) + sizeof( unsigned int ) ];
+	record[ 0 ] = operation;
+	memcpy( record + 1, &object, sizeof( Object ) );
+
+	unsigned int checksum = recordChecksum( record, 1 + sizeof( Object ) );
+	memcpy( record + 1 + sizeof( Object ), &checksum, sizeof( checksum ) );
+
+	pending.insert( pending.end( ), record, record + sizeof( record ) );
+	pendingOperations++;
+	sinceCheckpoint++;
+
+	if( pendingOperations >= syncEvery )
+		sync( );
+
+	/*--- A finished checkpoint is collected, and reports its failure. ---*/
+	if( checkpointer.joinable( ) && !checkpointRunning )
+		finishCheckpoint( );
+
+	/*--- The next checkpoint waits for the one still being written. ---*/
+	if( ( checkpointEvery > 0 ) && ( sinceCheckpoint >= checkpointEvery ) && !checkpointer.joinable( ) )
+		startCheckpoint( );
+}
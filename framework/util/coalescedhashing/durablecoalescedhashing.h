@@ -0,0 +1,212 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __DURABLE_COALESCED_HASHING_H__
+#define __DURABLE_COALESCED_HASHING_H__
+
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "coalescedhashing.h"
+#include "coalescedsnapshot.h"
+#include "const_ref.h"
+using std::vector;
+
+/**
+ * A coalesced hashing table kept durable by an append-only log of its
+ * insertions and removals, and by checkpoints of its slots.
+ *
+ * => Operations are applied to the table in memory, then appended to
+ *    a buffer that is written and synced to the log once every
+ *    setSyncInterval( ) operations, so a single fsync commits the whole
+ *    group.
+ *    A crash loses at most the operations since the last sync( ).
+ *
+ * => A checkpoint writes the occupied slots, with their links, to a
+ *    new file that then replaces the previous checkpoint.  The slots
+ *    are written from a snapshot by a background thread: the operation
+ *    that reaches the interval given to setCheckpointInterval( ) only
+ *    syncs the log, moves it aside as coalesced.log.previous, starts a
+ *    new log and takes the snapshot.  The moved log is deleted once the
+ *    checkpoint replaced the previous one.  checkpoint( ) takes one and
+ *    waits for it.  A failed background checkpoint throws from the next
+ *    operation, and the table takes no checkpoint until it is opened
+ *    again.
+ *
+ * => Opening a directory that holds a checkpoint puts its slots back
+ *    as they were, without inserting the records again, and replays
+ *    the logs written since.  The log is split by home address range
+ *    between threads, each of which reduces its operations to the
+ *    last one of every object, and the net removals and insertions
+ *    are then applied.  A torn record at the end of the log is
+ *    dropped.  Restarting costs a read of the checkpoint plus the
+ *    operations logged since it.
+ *
+ * => The Object must be trivially copyable, it is logged byte by byte.
+ *    The files are coalesced.checkpoint and coalesced.log in the given
+ *    directory, which must exist.  I/O failures, and a checkpoint of a
+ *    table of another size or algorithm, throw DurabilityException.
+*/
+
+template < class Object >
+class durable_coalesced_hashing {
+
+	public:
+
+		/*--- Opens or creates the table in the given directory, the whole table is the address region. ---*/
+		durable_coalesced_hashing( const char * directory, size_t size, bool eisch );
+
+		/*--- Opens or creates the table in the given directory, the rest of the address region is the cellar. ---*/
+		durable_coalesced_hashing( const char * directory, size_t size, bool eich, const double & addressFactor );
+
+		/*--- Syncs the operations still buffered and closes the log. ---*/
+		~durable_coalesced_hashing( );
+
+		/*--- Insert into the table. ---*/
+		void insert( const Object & object );
+
+		/* Insert into the table without throwing on a duplicate or full
+		 * table.  Only insertions are logged.
+		*/
+		InsertResult try_insert( const Object & object );
+
+		/*--- Removes the item from the table, returns 1 when removed and 0 when not stored. ---*/
+		int remove( const Object & object );
+
+		/*--- Find an item from the table. ---*/
+		const_ref< Object > find( const Object & object ) const;
+
+		/*--- Returns true if the item is stored in the table. ---*/
+		bool contains( const Object & object ) const;
+
+		/* Find an item from the table without throwing.
+		 * Returns NULL when the item is not stored.
+		*/
+		const Object * try_find( const Object & object ) const;
+
+		/*--- Sets the number of operations committed by one sync, 64 by default. ---*/
+		void setSyncInterval( size_t operations );
+
+		/*--- Sets the number of operations between checkpoints, zero to take them only on request. ---*/
+		void setCheckpointInterval( size_t operations );
+
+		/*--- Writes the buffered operations to the log and syncs it. ---*/
+		void sync( );
+
+		/*--- Writes a checkpoint of the slots and empties the log. ---*/
+		void checkpoint( );
+
+		/*--- Returns the number of logged operations replayed when the table was opened. ---*/
+		size_t replayedOperations( ) const;
+
+		/*--- Returns the table in memory. ---*/
+		const coalesced_hashing< Object > & table( ) const;
+
+		/*--- Returns the number of items currently within the table. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the size of the table. ---*/
+		size_t size( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Loads the checkpoint and replays the log, then opens the log for appending. ---*/
+		void open( );
+
+		/*--- Puts back the slots of the checkpoint, returns false when there is none. ---*/
+		bool loadCheckpoint( );
+
+		/*--- Replays the log over the table, and drops a torn record at its end. ---*/
+		void replayLog( );
+
+		/*--- Buffers an operation, and commits the group once it is full. ---*/
+		void append( unsigned char operation, const Object & object );
+
+		/* Syncs the log and moves it aside, then starts writing a checkpoint
+		 * of a snapshot of the table from a background thread.
+		*/
+		void startCheckpoint( );
+
+		/*--- Waits for the background checkpoint, throws DurabilityException when it failed. ---*/
+		void finishCheckpoint( );
+
+		/*--- Writes the checkpoint of the snapshot, and deletes the moved log once it is in place. ---*/
+		static void writeCheckpoint( coalesced_snapshot< Object > view, size_t addressSize, bool eisch,
+			std::string checkpointPath, std::string previousLogPath, std::string directoryPath,
+			std::atomic< bool > * running, bool * failed );
+
+		/* Checks the records of the given slice of the log, and hands out the
+		 * valid ones by the home range of their object.
+		*/
+		static void partitionLog( const coalesced_hashing< Object > & table, const vector< unsigned char > & log,
+			size_t begin, size_t end, size_t threads, vector< vector< size_t > > & ranges, size_t & invalid );
+
+		/*--- Reduces the records of one home range to the last operation on every object. ---*/
+		static void reduceRange( const vector< unsigned char > & log, const vector< vector< vector< size_t > > > & partitions,
+			size_t range, size_t valid, vector< Object > & removals, vector< Object > & insertions );
+
+		/*--- No copies, the files belong to one table. ---*/
+		durable_coalesced_hashing( const durable_coalesced_hashing & );
+		durable_coalesced_hashing & operator=( const durable_coalesced_hashing & );
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- Table in memory. ---*/
+		coalesced_hashing< Object > hashing;
+
+		/*--- Paths of the directory, of the checkpoint, of the log and of the log moved aside. ---*/
+		std::string directoryPath;
+		std::string checkpointPath;
+		std::string logPath;
+		std::string previousLogPath;
+
+		/*--- Log opened for appending. ---*/
+		FILE * log;
+
+		/*--- Operations not written to the log yet. ---*/
+		vector< unsigned char > pending;
+		size_t pendingOperations;
+
+		/*--- Operations per sync of the log. ---*/
+		size_t syncEvery;
+
+		/*--- Operations per checkpoint, zero when only checkpoint( ) takes them. ---*/
+		size_t checkpointEvery;
+
+		/*--- Operations logged since the last checkpoint. ---*/
+		size_t sinceCheckpoint;
+
+		/*--- Logged operations replayed when the table was opened. ---*/
+		size_t replayed;
+
+		/*--- Thread writing a checkpoint, running until it is done, and whether it failed. ---*/
+		std::thread checkpointer;
+		std::atomic< bool > checkpointRunning;
+		bool checkpointFailed;
+};
+
+#endif
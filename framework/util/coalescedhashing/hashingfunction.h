@@ -26,6 +26,8 @@
 #ifndef __HASH_FUNCTION_H__
 #define __HASH_FUNCTION_H__
 
+#include <stddef.h>
+
 /*--- Hashing Function. ---*/
 static unsigned int hash( int key ) {
 
@@ -33,4 +35,59 @@ static unsigned int hash( int key ) {
 	return key;
 }
 
+/* Seeded Hashing Function.
+ * The key is mixed with a secret per-table seed, so the home
+ * address of a key cannot be predicted without the seed.
+*/
+inline unsigned long long hash( int key, unsigned long long seed ) {
+
+	unsigned long long value = ( ( unsigned int ) key ^ seed ) * 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 32;
+	value = ( value ^ ( seed >> 29 ) ) * 0xC4CEB9FE1A85EC53ULL;
+	value ^= value >> 29;
+
+	return value;
+}
+
+/*--- Hashing Function for 64-bit keys. ---*/
+inline unsigned long long hash( unsigned long long key ) {
+
+	/*--- Returns the key. ---*/
+	return key;
+}
+
+/* Seeded Hashing Function for 64-bit keys.
+ * Both halves of the key are mixed with the seed.
+*/
+inline unsigned long long hash( unsigned long long key, unsigned long long seed ) {
+
+	unsigned long long value = ( key ^ seed ) * 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 32;
+	value = ( value ^ ( seed >> 29 ) ) * 0xC4CEB9FE1A85EC53ULL;
+	value ^= value >> 29;
+
+	return value;
+}
+
+/* Hashing Function for a sequence of bytes ( 64-bit FNV-1a ).
+ * Used for the string keys, the full value is kept next
+ * to each slot so it is only computed once per key.
+*/
+inline unsigned long long hash( const char * key, size_t length ) {
+
+	/*--- FNV offset basis. ---*/
+	unsigned long long value = 14695981039346656037ULL;
+
+	/*--- Mix in every byte of the key. ---*/
+	for( size_t i = 0; i < length; i++ ) {
+
+		value ^= ( unsigned char ) key[ i ];
+
+		/*--- FNV prime. ---*/
+		value *= 1099511628211ULL;
+	}
+
+	return value;
+}
+
 #endif
@@ -0,0 +1,167 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include "lookupscheduler.h"
+
+#if defined( __cpp_impl_coroutine )
+
+/*--- Returns the task owning the coroutine. ---*/
+lookup_task lookup_task::promise_type::get_return_object( ) {
+
+	return lookup_task( handle_type::from_promise( *this ) );
+}
+
+/*--- Requests start within the scheduler, not when called. ---*/
+std::suspend_always lookup_task::promise_type::initial_suspend( ) noexcept {
+
+	return std::suspend_always( );
+}
+
+/*--- Finished requests stay suspended, so the scheduler destroys them. ---*/
+std::suspend_always lookup_task::promise_type::final_suspend( ) noexcept {
+
+	return std::suspend_always( );
+}
+
+void lookup_task::promise_type::return_void( ) {
+}
+
+/*--- Keeps the exception for run( ). ---*/
+void lookup_task::promise_type::unhandled_exception( ) {
+
+	exception = std::current_exception( );
+}
+
+/*--- Owns the given coroutine. ---*/
+lookup_task::lookup_task( handle_type handle )
+	: handle( handle ) {
+}
+
+/*--- Takes over the request from the other task. ---*/
+lookup_task::lookup_task( lookup_task && other ) noexcept
+	: handle( other.handle ) {
+
+	other.handle = nullptr;
+}
+
+/*--- Destroys the request unless it was spawned. ---*/
+lookup_task::~lookup_task( ) {
+
+	if( handle )
+		handle.destroy( );
+}
+
+/*--- Scheduler running at most width requests at once. ---*/
+lookup_scheduler::lookup_scheduler( size_t width )
+	: width( ( width > 0 ) ? width : 1 ), running( 0 ), finished( 0 ) {
+}
+
+/*--- Destroys the requests that did not finish. ---*/
+lookup_scheduler::~lookup_scheduler( ) {
+
+	/*--- A suspended lookup lives in the frame of its request. ---*/
+	while( !lookups.empty( ) ) {
+
+		lookups.front( )->waiting.destroy( );
+		lookups.pop_front( );
+	}
+
+	while( !waiting.empty( ) ) {
+
+		waiting.front( ).destroy( );
+		waiting.pop_front( );
+	}
+}
+
+/*--- Queues the request, it starts within run( ). ---*/
+void lookup_scheduler::spawn( lookup_task && task ) {
+
+	task.handle.promise( ).scheduler = this;
+	waiting.push_back( task.handle );
+	task.handle = nullptr;
+}
+
+/*--- Queues a lookup that has to take a step, called by the awaitables. ---*/
+void lookup_scheduler::suspend( lookup_step * lookup ) {
+
+	lookups.push_back( lookup );
+}
+
+/* Runs the requests until all of them are over, and returns how many
+ * finished.  An exception thrown by a request is rethrown once the
+ * request is destroyed, the others stay queued.
+*/
+size_t lookup_scheduler::run( ) {
+
+	size_t before = finished;
+
+	while( !waiting.empty( ) || !lookups.empty( ) ) {
+
+		/*--- Keep width requests in progress. ---*/
+		while( ( running < width ) && !waiting.empty( ) ) {
+
+			lookup_task::handle_type handle = waiting.front( );
+			waiting.pop_front( );
+
+			running++;
+			resume( handle );
+		}
+
+		/*--- One hop of the oldest lookup, whose slot was prefetched a round ago. ---*/
+		if( !lookups.empty( ) ) {
+
+			lookup_step * lookup = lookups.front( );
+			lookups.pop_front( );
+
+			if( lookup->step( ) )
+				resume( lookup->waiting );
+
+			else
+				lookups.push_back( lookup );
+		}
+	}
+
+	return finished - before;
+}
+
+/*--- Resumes the request, and destroys it when it is over. ---*/
+void lookup_scheduler::resume( lookup_task::handle_type handle ) {
+
+	/*--- Runs till its next lookup suspends it, or till it is over. ---*/
+	handle.resume( );
+	if( !handle.done( ) )
+		return;
+
+	std::exception_ptr exception = handle.promise( ).exception;
+	handle.destroy( );
+
+	running--;
+	finished++;
+
+	if( exception )
+		std::rethrow_exception( exception );
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __LOOKUP_SCHEDULER_H__
+#define __LOOKUP_SCHEDULER_H__
+
+/*--- Coroutines need C++20, the rest of the tables do not. ---*/
+#if defined( __cpp_impl_coroutine )
+
+#include <stddef.h>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <vector>
+using std::vector;
+
+class lookup_scheduler;
+
+/**
+ * Coroutine type of a request run by a lookup_scheduler.  Inside it,
+ * co_await table.async_find( object ) walks the probe chain one slot per
+ * turn of the scheduler, and the other requests run their own hops while
+ * the prefetched slot is loaded.
+ *
+ *		lookup_task request( const coalesced_hashing< int > & table, int key ) {
+ *
+ *			const_ref< int > found = co_await table.async_find( key );
+ *			...
+ *		}
+ *
+ *		lookup_scheduler scheduler;
+ *		scheduler.spawn( request( table, 42 ) );
+ *		scheduler.run( );
+*/
+
+class lookup_task {
+
+	public:
+
+		struct promise_type {
+
+			/*--- Scheduler the request was spawned on, set by spawn( ). ---*/
+			lookup_scheduler * scheduler = nullptr;
+
+			/*--- Exception that left the request, rethrown by run( ). ---*/
+			std::exception_ptr exception;
+
+			lookup_task get_return_object( );
+			std::suspend_always initial_suspend( ) noexcept;
+			std::suspend_always final_suspend( ) noexcept;
+			void return_void( );
+			void unhandled_exception( );
+		};
+
+		typedef std::coroutine_handle< promise_type > handle_type;
+
+		/*--- Takes over the request from the other task. ---*/
+		lookup_task( lookup_task && other ) noexcept;
+
+		/*--- Destroys the request unless it was spawned. ---*/
+		~lookup_task( );
+
+	private:
+
+		friend class lookup_scheduler;
+
+		explicit lookup_task( handle_type handle );
+
+		/*--- No copies, a request has a single owner. ---*/
+		lookup_task( const lookup_task & );
+		lookup_task & operator=( const lookup_task & );
+
+		handle_type handle;
+};
+
+/* A lookup suspended within a probe chain.  step( ) looks at the slot
+ * prefetched by the previous step, prefetches the next one and returns
+ * false, or returns true once the lookup is over.
+*/
+class lookup_step {
+
+	public:
+
+		virtual bool step( ) = 0;
+
+		/*--- Request resumed once the lookup is over. ---*/
+		lookup_task::handle_type waiting;
+
+	protected:
+
+		~lookup_step( ) { }
+};
+
+/**
+ * Interleaves the lookups of many requests on one thread.  At most width
+ * requests are in progress at once, the others wait to be started.  The
+ * lookups in progress take turns by one chain hop each, so the memory
+ * loads of independent requests overlap instead of stalling one by one.
+ * The width is the number of loads in flight, and should be about what
+ * the core can keep outstanding, 16 by default.
+*/
+
+class lookup_scheduler {
+
+	public:
+
+		/*--- Scheduler running at most width requests at once. ---*/
+		explicit lookup_scheduler( size_t width = 16 );
+
+		/*--- Destroys the requests that did not finish. ---*/
+		~lookup_scheduler( );
+
+		/*--- Queues the request, it starts within run( ). ---*/
+		void spawn( lookup_task && task );
+
+		/*--- Queues a lookup that has to take a step, called by the awaitables. ---*/
+		void suspend( lookup_step * lookup );
+
+		/* Runs the requests until all of them are over, and returns how many
+		 * finished.  An exception thrown by a request is rethrown once the
+		 * request is destroyed, the others stay queued.
+		*/
+		size_t run( );
+
+	private:
+
+		/*--- Resumes the request, and destroys it when it is over. ---*/
+		void resume( lookup_task::handle_type handle );
+
+		/*--- No copies, the requests belong to one scheduler. ---*/
+		lookup_scheduler( const lookup_scheduler & );
+		lookup_scheduler & operator=( const lookup_scheduler & );
+
+	private:
+
+		/*--- Maximum number of requests in progress. ---*/
+		size_t width;
+
+		/*--- Requests in progress. ---*/
+		size_t running;
+
+		/*--- Requests finished since the scheduler was created. ---*/
+		size_t finished;
+
+		/*--- Requests spawned and not started yet. ---*/
+		std::deque< lookup_task::handle_type > waiting;
+
+		/*--- Lookups taking turns, one step each. ---*/
+		std::deque< lookup_step * > lookups;
+};
+
+#endif
+
+#endif
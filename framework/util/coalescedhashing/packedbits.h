@@ -0,0 +1,122 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __PACKED_BITS_H__
+#define __PACKED_BITS_H__
+
+#include <stddef.h>
+#include <vector>
+using std::vector;
+
+/**
+ * Array of bits stored in 64-bit words, read and written as fields of
+ * up to 64 bits at any bit offset.  Tables that pack their slots into
+ * fewer bits than a machine word keep them here one after the other.
+*/
+
+class packed_bits {
+
+	public:
+
+		/*--- Constructor, every bit is zero. ---*/
+		packed_bits( size_t bits = 0 ) {
+
+			assign( bits );
+		}
+
+		/*--- Holds the given number of bits, all of them zero, plus a word so a field never reads past the end. ---*/
+		void assign( size_t bits ) {
+
+			words.assign( ( bits + 63 ) / 64 + 1, 0 );
+		}
+
+		/*--- Sets every bit to zero. ---*/
+		void clear( ) {
+
+			for( size_t i = 0; i < words.size( ); i++ )
+				words[ i ] = 0;
+		}
+
+		/*--- Reads width bits, at most 64, from the given bit offset. ---*/
+		unsigned long long read( size_t offset, size_t width ) const {
+
+			if( width == 0 )
+				return 0;
+
+			size_t word = offset / 64;
+			size_t shift = offset % 64;
+
+			/*--- A field may straddle two words. ---*/
+			unsigned long long value = words[ word ] >> shift;
+			if( shift + width > 64 )
+				value |= words[ word + 1 ] << ( 64 - shift );
+
+			return ( width < 64 ) ? ( value & ( ( 1ULL << width ) - 1 ) ) : value;
+		}
+
+		/*--- Writes the low width bits of the value, at most 64, at the given bit offset. ---*/
+		void write( size_t offset, size_t width, unsigned long long value ) {
+
+			if( width == 0 )
+				return;
+
+			size_t word = offset / 64;
+			size_t shift = offset % 64;
+			unsigned long long mask = ( width < 64 ) ? ( ( 1ULL << width ) - 1 ) : ~0ULL;
+
+			value &= mask;
+			words[ word ] = ( words[ word ] & ~( mask << shift ) ) | ( value << shift );
+
+			/*--- A field may straddle two words. ---*/
+			if( shift + width > 64 )
+				words[ word + 1 ] = ( words[ word + 1 ] & ~( mask >> ( 64 - shift ) ) ) | ( value >> ( 64 - shift ) );
+		}
+
+		/*--- Returns the number of bytes of the words. ---*/
+		size_t memory( ) const {
+
+			return words.capacity( ) * sizeof( unsigned long long );
+		}
+
+		/*--- Returns the number of bits needed to write the given value. ---*/
+		static size_t bitWidth( unsigned long long value ) {
+
+			size_t width = 0;
+			while( value != 0 ) {
+
+				width++;
+				value >>= 1;
+			}
+
+			return width;
+		}
+
+	private:
+
+		/*--- Stores the bits, the first at the low bit of the first word. ---*/
+		vector< unsigned long long > words;
+};
+
+#endif
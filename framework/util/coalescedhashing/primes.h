@@ -0,0 +1,137 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __PRIMES_H__
+#define __PRIMES_H__
+
+#if !defined( __SIZEOF_INT128__ ) && defined( _M_X64 )
+#include <intrin.h>
+#endif
+
+/*--- Returns a * b % m without overflow. ---*/
+static unsigned long long mulMod( unsigned long long a, unsigned long long b, unsigned long long m ) {
+
+#if defined( __SIZEOF_INT128__ )
+	return ( unsigned long long )( ( unsigned __int128 )a * b % m );
+#elif defined( _M_X64 )
+	unsigned long long high, remainder;
+	unsigned long long low = _umul128( a, b, &high );
+	_udiv128( high, low, m, &remainder );
+	return remainder;
+#else
+	/*--- Double and add. ---*/
+	unsigned long long result = 0;
+	for( a %= m; b > 0; b >>= 1 ) {
+
+		if( b & 1 )
+			result = ( result >= m - a ) ? result - ( m - a ) : result + a;
+
+		a = ( a >= m - a ) ? a - ( m - a ) : a + a;
+	}
+
+	return result;
+#endif
+}
+
+/*--- Returns base ^ exponent % m. ---*/
+static unsigned long long powMod( unsigned long long base, unsigned long long exponent, unsigned long long m ) {
+
+	unsigned long long result = 1;
+	for( base %= m; exponent > 0; exponent >>= 1 ) {
+
+		if( exponent & 1 )
+			result = mulMod( result, base, m );
+
+		base = mulMod( base, base, m );
+	}
+
+	return result;
+}
+
+/* Returns true if the given number is a prime.  Miller-Rabin with the
+ * first twelve primes as bases, which is exact for every 64-bit number.
+*/
+static bool isPrime( unsigned long long n ) {
+
+	static const unsigned long long bases[ ] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+	if( n < 2 )
+		return false;
+
+	/*--- Small primes and their multiples. ---*/
+	for( int i = 0; i < 12; i++ ) {
+
+		if( n == bases[ i ] )
+			return true;
+
+		if( n % bases[ i ] == 0 )
+			return false;
+	}
+
+	/*--- n - 1 = d * 2^r with d odd. ---*/
+	unsigned long long d = n - 1;
+	int r = 0;
+	for( ; ( d & 1 ) == 0; d >>= 1 )
+		r++;
+
+	for( int i = 0; i < 12; i++ ) {
+
+		unsigned long long x = powMod( bases[ i ], d, n );
+		if( ( x == 1 ) || ( x == n - 1 ) )
+			continue;
+
+		/*--- Square until n - 1 shows up, else the base is a witness. ---*/
+		bool witness = true;
+		for( int j = 1; ( j < r ) && witness; j++ ) {
+
+			x = mulMod( x, x, n );
+			if( x == n - 1 )
+				witness = false;
+		}
+
+		if( witness )
+			return false;
+	}
+
+	return true;
+}
+
+/* Function to find the Next Prime.
+ * Assuming n > 0.
+*/
+static unsigned long long nextPrime( unsigned long long n ) {
+
+	/*--- If it is not even, increment to make it odd. ---*/
+	if( n % 2 == 0 )
+		n++;
+
+	/*--- Now find the next prime number. ---*/
+	for( ; !isPrime( n ); n += 2 )
+		;
+
+	return n;
+}
+
+#endif
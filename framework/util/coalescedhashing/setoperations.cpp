@@ -0,0 +1,295 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <thread>
+#include "setoperations.h"
+#include "exceptions.h"
+
+/*--- Number of objects looked up together. ---*/
+#define PROBE_BATCH 64
+
+/*--- Inputs smaller than this are not worth a thread. ---*/
+#define MINIMUM_PER_THREAD 16384
+
+/*--- Slots or objects of the stream a thread looks up per round, which bounds the objects it keeps. ---*/
+#define ROUND_PER_THREAD 65536
+
+/* Looks up the objects of the scanned table within the given slot range
+ * in the probed table, and keeps those whose presence is the wanted one.
+*/
+template < class Object >
+static void probeSlots( const coalesced_hashing< Object > & scanned, size_t begin, size_t end,
+	const coalesced_hashing< Object > & probed, bool wanted, vector< Object > & output ) {
+
+	Object batch[ PROBE_BATCH ];
+	bool found[ PROBE_BATCH ];
+	size_t batched = 0;
+
+	for( size_t pos = begin; pos < end; pos++ ) {
+
+		if( scanned.isOccupied( pos ) )
+			batch[ batched++ ] = scanned.objectAt( pos );
+
+		/*--- Look the batch up once it is full, or at the end of the range. ---*/
+		if( ( batched == PROBE_BATCH ) || ( ( pos + 1 == end ) && ( batched > 0 ) ) ) {
+
+			probed.contains( batch, batched, found );
+			for( size_t i = 0; i < batched; i++ )
+				if( found[ i ] == wanted )
+					output.push_back( batch[ i ] );
+
+			batched = 0;
+		}
+	}
+}
+
+/*--- Looks up the objects of the stream within the given range in the table, and keeps the stored ones. ---*/
+template < class Object >
+static void probeStream( const Object * stream, size_t begin, size_t end,
+	const coalesced_hashing< Object > & probed, vector< Object > & output ) {
+
+	bool found[ PROBE_BATCH ];
+	for( size_t first = begin; first < end; first += PROBE_BATCH ) {
+
+		size_t batched = ( end - first < PROBE_BATCH ) ? end - first : PROBE_BATCH;
+
+		probed.contains( stream + first, batched, found );
+		for( size_t i = 0; i < batched; i++ )
+			if( found[ i ] )
+				output.push_back( stream[ first + i ] );
+	}
+}
+
+/*--- Returns the number of threads to use for the given amount of work. ---*/
+static int threadCount( int threads, size_t work ) {
+
+	if( threads <= 0 )
+		threads = ( int )std::thread::hardware_concurrency( );
+
+	if( ( size_t )threads > work / MINIMUM_PER_THREAD )
+		threads = ( int )( work / MINIMUM_PER_THREAD );
+
+	return ( threads < 1 ) ? 1 : threads;
+}
+
+/* Emits the objects kept by every thread in thread order, which is the
+ * order of the input, and empties the outputs for the next round.
+*/
+template < class Object >
+static size_t emit( vector< vector< Object > > & outputs,
+	void ( *callback )( const Object & object, void * context ), void * context ) {
+
+	size_t emitted = 0;
+	for( size_t t = 0; t < outputs.size( ); t++ ) {
+
+		for( size_t i = 0; i < outputs[ t ].size( ); i++ )
+			callback( outputs[ t ][ i ], context );
+
+		emitted += outputs[ t ].size( );
+		outputs[ t ].clear( );
+	}
+
+	return emitted;
+}
+
+/*--- Throws IsCacheException for a table in cache mode, whose lookups write its counters. ---*/
+template < class Object >
+static void checkNotCache( const coalesced_hashing< Object > & table ) {
+
+	if( table.isCache( ) )
+		throw IsCacheException( );
+}
+
+/* Splits the slots of the scanned table between the threads in rounds
+ * of ROUND_PER_THREAD slots per thread, and emits the kept objects of
+ * every round in slot order before the next round starts.
+*/
+template < class Object >
+static size_t probeTable( const coalesced_hashing< Object > & scanned, const coalesced_hashing< Object > & probed,
+	bool wanted, void ( *callback )( const Object & object, void * context ), void * context, int threads ) {
+
+	checkNotCache( scanned );
+	checkNotCache( probed );
+
+	threads = threadCount( threads, scanned.size( ) );
+	vector< vector< Object > > outputs( threads );
+
+	size_t emitted = 0;
+	for( size_t first = 0; first < scanned.size( ); ) {
+
+		size_t last = ( scanned.size( ) - first > ( size_t )threads * ROUND_PER_THREAD ) ?
+			first + ( size_t )threads * ROUND_PER_THREAD : scanned.size( );
+
+		if( threads == 1 )
+			probeSlots( scanned, first, last, probed, wanted, outputs[ 0 ] );
+
+		else {
+
+			size_t share = ( last - first + threads - 1 ) / threads;
+
+			vector< std::thread > workers;
+			for( int t = 0; t < threads; t++ ) {
+
+				size_t begin = ( first + t * share < last ) ? first + t * share : last;
+				size_t end = ( begin + share < last ) ? begin + share : last;
+				workers.push_back( std::thread( probeSlots< Object >, std::cref( scanned ), begin, end,
+					std::cref( probed ), wanted, std::ref( outputs[ t ] ) ) );
+			}
+
+			for( int t = 0; t < threads; t++ )
+				workers[ t ].join( );
+		}
+
+		emitted += emit( outputs, callback, context );
+		first = last;
+	}
+
+	return emitted;
+}
+
+/*--- Callback that inserts the object into the table given as context. ---*/
+template < class Object >
+static void insertInto( const Object & object, void * context ) {
+
+	InsertStatus status = ( ( coalesced_hashing< Object > * )context )->try_insert( object ).status;
+
+	if( status == FULL )
+		throw IsFullException( );
+
+	else if( status == FROZEN )
+		throw IsFrozenException( );
+}
+
+/*--- Emits the objects stored in both tables. ---*/
+template < class Object >
+size_t intersect( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads ) {
+
+	/*--- Scan the smaller table, probe the larger one. ---*/
+	if( a.elements( ) <= b.elements( ) )
+		return probeTable( a, b, true, callback, context, threads );
+
+	return probeTable( b, a, true, callback, context, threads );
+}
+
+template < class Object >
+size_t intersect( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads ) {
+
+	return intersect( a, b, insertInto< Object >, &output, threads );
+}
+
+/*--- Emits the objects stored in either table, once. ---*/
+template < class Object >
+size_t unite( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads ) {
+
+	checkNotCache( a );
+	checkNotCache( b );
+
+	const coalesced_hashing< Object > & smaller = ( a.elements( ) <= b.elements( ) ) ? a : b;
+	const coalesced_hashing< Object > & larger = ( a.elements( ) <= b.elements( ) ) ? b : a;
+
+	/*--- The larger table as a whole, it needs no lookups. ---*/
+	size_t emitted = 0;
+	for( size_t pos = 0; pos < larger.size( ); pos++ ) {
+
+		if( larger.isOccupied( pos ) ) {
+
+			callback( larger.objectAt( pos ), context );
+			emitted++;
+		}
+	}
+
+	/*--- Then the objects that are only in the smaller table. ---*/
+	return emitted + probeTable( smaller, larger, false, callback, context, threads );
+}
+
+template < class Object >
+size_t unite( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads ) {
+
+	return unite( a, b, insertInto< Object >, &output, threads );
+}
+
+/*--- Emits the objects of a that are not stored in b. ---*/
+template < class Object >
+size_t difference( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads ) {
+
+	return probeTable( a, b, false, callback, context, threads );
+}
+
+template < class Object >
+size_t difference( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads ) {
+
+	return difference( a, b, insertInto< Object >, &output, threads );
+}
+
+/* Probes a stream of objects against a table and emits, in stream
+ * order, the objects that are stored in it.
+*/
+template < class Object >
+size_t semiJoin( const coalesced_hashing< Object > & table, const Object * stream, size_t count,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads ) {
+
+	checkNotCache( table );
+
+	threads = threadCount( threads, count );
+	vector< vector< Object > > outputs( threads );
+
+	size_t emitted = 0;
+	for( size_t first = 0; first < count; ) {
+
+		size_t last = ( count - first > ( size_t )threads * ROUND_PER_THREAD ) ?
+			first + ( size_t )threads * ROUND_PER_THREAD : count;
+
+		if( threads == 1 )
+			probeStream( stream, first, last, table, outputs[ 0 ] );
+
+		else {
+
+			size_t share = ( last - first + threads - 1 ) / threads;
+
+			vector< std::thread > workers;
+			for( int t = 0; t < threads; t++ ) {
+
+				size_t begin = ( first + t * share < last ) ? first + t * share : last;
+				size_t end = ( begin + share < last ) ? begin + share : last;
+				workers.push_back( std::thread( probeStream< Object >, stream, begin, end,
+					std::cref( table ), std::ref( outputs[ t ] ) ) );
+			}
+
+			for( int t = 0; t < threads; t++ )
+				workers[ t ].join( );
+		}
+
+		emitted += emit( outputs, callback, context );
+		first = last;
+	}
+
+	return emitted;
+}
@@ -0,0 +1,92 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __SET_OPERATIONS_H__
+#define __SET_OPERATIONS_H__
+
+#include "coalescedhashing.h"
+
+/**
+ * Set algebra and join kernels between coalesced hashing tables.
+ *
+ * => The smaller table is scanned slot by slot, sequentially, and its
+ *    objects are looked up in the larger table in batches whose home
+ *    slots are prefetched.  The input is processed in rounds of at
+ *    most 65536 slots or objects per thread, split between threads
+ *    that keep their output.  Once all threads of a round are done,
+ *    the outputs are emitted in input order from the calling thread,
+ *    so no more than a round of objects is held at any time.
+ *
+ * => The output goes to a callback, called with the given context,
+ *    or is inserted into a table.  Objects already stored in the
+ *    output table are skipped.  IsFullException or IsFrozenException
+ *    is thrown when the output table cannot take an object.
+ *
+ * => A thread count of 0 uses every hardware thread, small inputs are
+ *    always processed by the calling thread.  The tables must not be
+ *    modified while an operation runs.  The lookups of a table in cache
+ *    mode update its counters, so IsCacheException is thrown when an
+ *    input table is in cache mode.  Every function returns the number
+ *    of objects emitted.
+*/
+
+/*--- Emits the objects stored in both tables. ---*/
+template < class Object >
+size_t intersect( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads = 0 );
+
+template < class Object >
+size_t intersect( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads = 0 );
+
+/*--- Emits the objects stored in either table, once. ---*/
+template < class Object >
+size_t unite( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads = 0 );
+
+template < class Object >
+size_t unite( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads = 0 );
+
+/* Emits the objects of a that are not stored in b.
+ * Here a is always the scanned table, whatever its size.
+*/
+template < class Object >
+size_t difference( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads = 0 );
+
+template < class Object >
+size_t difference( const coalesced_hashing< Object > & a, const coalesced_hashing< Object > & b,
+	coalesced_hashing< Object > & output, int threads = 0 );
+
+/* Probes a stream of objects against a table and emits, in stream
+ * order, the objects that are stored in it.  Every occurrence
+ * of an object within the stream is emitted.
+*/
+template < class Object >
+size_t semiJoin( const coalesced_hashing< Object > & table, const Object * stream, size_t count,
+	void ( *callback )( const Object & object, void * context ), void * context, int threads = 0 );
+
+#endif
@@ -0,0 +1,392 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include <new>
+#include <type_traits>
+#include "sharedcoalescedhashing.h"
+#include "hashingfunction.h"
+#include "primes.h"
+#include "exceptions.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define SHARED_MEMORY_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*--- Marks a segment whose header is complete. ---*/
+#define SHARED_TABLE_MAGIC 0x434f414c45534345ULL
+
+/*--- Offset of the slots, past the header on its own cache line. ---*/
+#define SHARED_HEADER_BYTES ( ( sizeof( SharedHeader ) + 63 ) / 64 * 64 )
+
+/*--- Creates the segment with the given name, the whole table is the address region. ---*/
+template < class Object >
+shared_coalesced_hashing< Object >::shared_coalesced_hashing( const char * name, size_t size, bool eisch ) {
+
+	size_t slots = nextPrime( size );
+	create( name, slots, eisch, -1.0, slots );
+}
+
+/*--- Creates the segment with the given name, the rest of the address region is the cellar. ---*/
+template < class Object >
+shared_coalesced_hashing< Object >::shared_coalesced_hashing( const char * name, size_t size, bool eich, const double & addressFactor ) {
+
+	/*--- Default in case is less than zero or greater than 1. ---*/
+	double factor = addressFactor;
+	if( ( factor < 0.0 ) || ( factor > 1.0 ) )
+		factor = 0.86;
+
+	size_t slots = nextPrime( size );
+	create( name, slots, eich, factor, ( size_t )( factor * slots ) );
+}
+
+/*--- Creates and maps the segment. ---*/
+template < class Object >
+void shared_coalesced_hashing< Object >::create( const char * name, size_t size, bool eisch, double addressFactor, size_t addressSize ) {
+
+	static_assert( std::is_trivially_copyable< Object >::value, "Objects are shared between processes byte by byte." );
+	static_assert( sizeof( SharedHeader ) == 64, "The header is laid out alike in every process." );
+
+	writer = true;
+	segmentSize = SHARED_HEADER_BYTES + size * sizeof( SharedEntry );
+
+#ifdef SHARED_MEMORY_POSIX
+	/*--- Never take over the segment of another table. ---*/
+	int fd = shm_open( name, O_CREAT | O_EXCL | O_RDWR, 0644 );
+	if( fd < 0 )
+		throw SharedMemoryException( );
+
+	/*--- The new pages read as zeros, which are empty slots. ---*/
+	if( ftruncate( fd, ( off_t )segmentSize ) != 0 ) {
+
+		close( fd );
+		shm_unlink( name );
+		throw SharedMemoryException( );
+	}
+
+	segment = mmap( NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+
+	if( segment == MAP_FAILED ) {
+
+		shm_unlink( name );
+		throw SharedMemoryException( );
+	}
+#else
+	throw SharedMemoryException( );
+#endif
+
+	header = new ( segment ) SharedHeader( );
+	array = ( SharedEntry * )( ( char * )segment + SHARED_HEADER_BYTES );
+
+	header->objectSize = sizeof( Object );
+	header->size = size;
+	header->addressSize = addressSize;
+	header->addressFactor = addressFactor;
+	header->eisch = eisch ? 1 : 0;
+	header->occupied.store( 0, std::memory_order_relaxed );
+
+	/*--- Table Size - 1. ---*/
+	header->unoccupiedPos.store( size - 1, std::memory_order_relaxed );
+
+	/*--- Readers may attach from now on. ---*/
+	header->magic.store( SHARED_TABLE_MAGIC, std::memory_order_release );
+}
+
+/* Attaches to an existing segment, as a reader by default, or as
+ * its writer again once the previous writer is gone.
+*/
+template < class Object >
+shared_coalesced_hashing< Object >::shared_coalesced_hashing( const char * name, bool writable ) {
+
+	writer = writable;
+
+#ifdef SHARED_MEMORY_POSIX
+	int fd = shm_open( name, writable ? O_RDWR : O_RDONLY, 0 );
+	if( fd < 0 )
+		throw SharedMemoryException( );
+
+	struct stat status;
+	if( ( fstat( fd, &status ) != 0 ) || ( ( size_t )status.st_size < SHARED_HEADER_BYTES ) ) {
+
+		close( fd );
+		throw SharedMemoryException( );
+	}
+
+	/*--- Readers cannot write into the table. ---*/
+	segmentSize = ( size_t )status.st_size;
+	segment = mmap( NULL, segmentSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+
+	if( segment == MAP_FAILED )
+		throw SharedMemoryException( );
+#else
+	throw SharedMemoryException( );
+#endif
+
+	header = ( SharedHeader * )segment;
+	array = ( SharedEntry * )( ( char * )segment + SHARED_HEADER_BYTES );
+
+	/*--- The segment must be complete and hold objects of this type. ---*/
+	if( ( header->magic.load( std::memory_order_acquire ) != SHARED_TABLE_MAGIC ) ||
+		( header->objectSize != sizeof( Object ) ) ||
+		( SHARED_HEADER_BYTES + header->size * sizeof( SharedEntry ) > segmentSize ) ) {
+
+#ifdef SHARED_MEMORY_POSIX
+		munmap( segment, segmentSize );
+#endif
+		throw SharedMemoryException( );
+	}
+}
+
+/*--- Unmaps the segment, which lives on until it is removed. ---*/
+template < class Object >
+shared_coalesced_hashing< Object >::~shared_coalesced_hashing( ) {
+
+#ifdef SHARED_MEMORY_POSIX
+	munmap( segment, segmentSize );
+#endif
+}
+
+/*--- Removes the segment with the given name, mapped tables remain usable. ---*/
+template < class Object >
+bool shared_coalesced_hashing< Object >::remove( const char * name ) {
+
+#ifdef SHARED_MEMORY_POSIX
+	return shm_unlink( name ) == 0;
+#else
+	return false;
+#endif
+}
+
+/*--- Insert into the table. ---*/
+template < class Object >
+void shared_coalesced_hashing< Object >::insert( const Object & object ) {
+
+	/*--- Try to insert the item. ---*/
+	InsertResult result = try_insert( object );
+
+	if( result.status == DUPLICATE ) /*--- Already stored. ---*/
+		throw DuplicateItemException( );
+
+	else if( result.status == FULL ) /*--- No empty location left. ---*/
+		throw IsFullException( );
+
+	else if( result.status == FROZEN ) /*--- Readers are read-only. ---*/
+		throw IsFrozenException( );
+}
+
+/* Insert into the table without throwing.  Every store that makes
+ * the record reachable is a release, after the record is written.
+*/
+template < class Object >
+InsertResult shared_coalesced_hashing< Object >::try_insert( const Object & object ) {
+
+	if( !writer ) {
+
+		InsertResult readOnly = { FROZEN, END_OF_CHAIN };
+		return readOnly;
+	}
+
+	/*--- Get the position to insert the object. ---*/
+	size_t pos = findPos( object );
+
+	SearchedResult result = findInProbeChain( object, pos );
+	if( result.probes > 0 ) { /*--- Already stored. ---*/
+
+		InsertResult duplicate = { DUPLICATE, result.pos };
+		return duplicate;
+	}
+
+	InsertResult inserted = { INSERTED, pos };
+
+	/*--- If there is nothing in the home address. ---*/
+	if( result.pos == END_OF_CHAIN ) {
+
+		array[ pos ].object = object;
+		array[ pos ].next.store( 0, std::memory_order_relaxed );
+		array[ pos ].status.store( ACTIVE, std::memory_order_release );
+
+		header->occupied.fetch_add( 1, std::memory_order_release );
+		return inserted;
+	}
+
+	/* Find the bottommost empty location in the table.
+	 * If none is found, report a "full table".
+	*/
+	size_t unoccupiedPos = header->unoccupiedPos.load( std::memory_order_relaxed );
+	while( ( unoccupiedPos != END_OF_CHAIN ) && ( array[ unoccupiedPos ].status.load( std::memory_order_relaxed ) == ACTIVE ) )
+		unoccupiedPos--;
+
+	header->unoccupiedPos.store( unoccupiedPos, std::memory_order_relaxed );
+
+	if( unoccupiedPos == END_OF_CHAIN ) {
+
+		InsertResult full = { FULL, END_OF_CHAIN };
+		return full;
+	}
+
+	/*--- Write the record, its link, and publish it before linking to it. ---*/
+	array[ unoccupiedPos ].object = object;
+
+	if( !header->eisch ) {
+
+		array[ unoccupiedPos ].next.store( 0, std::memory_order_relaxed );
+		array[ unoccupiedPos ].status.store( ACTIVE, std::memory_order_release );
+
+		/*--- Link it at the end of the chain. ---*/
+		array[ result.pos ].next.store( unoccupiedPos + 1, std::memory_order_release );
+	}
+
+	else {
+
+		/*--- Link it right after the home address. ---*/
+		array[ unoccupiedPos ].next.store( array[ pos ].next.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+		array[ unoccupiedPos ].status.store( ACTIVE, std::memory_order_release );
+
+		array[ pos ].next.store( unoccupiedPos + 1, std::memory_order_release );
+	}
+
+	header->occupied.fetch_add( 1, std::memory_order_release );
+
+	inserted.pos = unoccupiedPos;
+	return inserted;
+}
+
+/*--- Find an item from the table. ---*/
+template < class Object >
+const_ref< Object > shared_coalesced_hashing< Object >::find( const Object & object ) const {
+
+	SearchedResult result = findInProbeChain( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return const_ref< Object >( );
+
+	size_t next = ( size_t )array[ result.pos ].next.load( std::memory_order_acquire );
+	return const_ref< Object >( array[ result.pos ].object, next - 1, result.probes );
+}
+
+/*--- Returns true if the item is stored in the table. ---*/
+template < class Object >
+bool shared_coalesced_hashing< Object >::contains( const Object & object ) const {
+
+	return findInProbeChain( object, findPos( object ) ).probes > 0;
+}
+
+/* Find an item from the table without throwing.
+ * Returns NULL when the item is not stored.
+*/
+template < class Object >
+const Object * shared_coalesced_hashing< Object >::try_find( const Object & object ) const {
+
+	SearchedResult result = findInProbeChain( object, findPos( object ) );
+	if( result.probes == 0 ) /*--- Not found. ---*/
+		return NULL;
+
+	return &array[ result.pos ].object;
+}
+
+/*--- Returns true if this process is the writer of the table. ---*/
+template < class Object >
+bool shared_coalesced_hashing< Object >::isWriter( ) const {
+
+	return writer;
+}
+
+/*--- Returns the number of items currently within the table. ---*/
+template < class Object >
+size_t shared_coalesced_hashing< Object >::elements( ) const {
+
+	return ( size_t )header->occupied.load( std::memory_order_acquire );
+}
+
+/*--- Returns the size of the table. ---*/
+template < class Object >
+size_t shared_coalesced_hashing< Object >::size( ) const {
+
+	return ( size_t )header->size;
+}
+
+/*--- Returns the number of bytes of the segment. ---*/
+template < class Object >
+size_t shared_coalesced_hashing< Object >::memory( ) const {
+
+	return segmentSize;
+}
+
+/*--- Returns the position for the given object. ---*/
+template < class Object >
+size_t shared_coalesced_hashing< Object >::findPos( const Object & obj ) const {
+
+	/*--- The home address is always within the address region. ---*/
+	return hash( obj ) % header->addressSize;
+}
+
+/* Searches the given object starting at the given position till the
+ * end of probe chain.  Statuses and links are acquired, so the records
+ * they lead to are complete.
+*/
+template < class Object >
+SearchedResult shared_coalesced_hashing< Object >::findInProbeChain( const Object & obj, size_t pos ) const {
+
+	SearchedResult result;
+	result.probes = 0;
+	result.pos = END_OF_CHAIN;
+	result.length = 0;
+
+	/*--- An empty home address starts no chain. ---*/
+	if( array[ pos ].status.load( std::memory_order_acquire ) != ACTIVE ) {
+
+		result.length = 1;
+		return result;
+	}
+
+	size_t last = pos;
+	size_t visited = 0;
+	while( pos != END_OF_CHAIN ) {
+
+		visited++;
+
+		/*--- Check if this position contains the given item. ---*/
+		if( obj == array[ pos ].object ) {
+
+			result.probes = visited;
+			result.pos = pos;
+			result.length = visited;
+			return result;
+		}
+
+		/*--- find the next link position. ---*/
+		last = pos;
+		pos = ( size_t )array[ pos ].next.load( std::memory_order_acquire ) - 1;
+	}
+
+	/*--- Not found, the position is the last element within the probe chain. ---*/
+	result.pos = last;
+	result.length = visited;
+	return result;
+}
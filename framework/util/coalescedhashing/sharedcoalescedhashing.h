@@ -0,0 +1,189 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __SHARED_COALESCED_HASHING_H__
+#define __SHARED_COALESCED_HASHING_H__
+
+#include <atomic>
+#include <stdint.h>
+#include "coalescedhashing.h"
+#include "const_ref.h"
+
+/**
+ * A coalesced hashing table stored in a POSIX shared memory segment,
+ * so that the processes of a host share one copy of it.
+ *
+ * => The segment starts with a header holding the size, the address
+ *    region, the algorithm, the number of occupied slots and the
+ *    bottommost empty slot, followed by the slots.  Links are slot
+ *    indices, so every process may map the segment at any address.
+ *
+ * => The process that creates the segment is its only writer, the
+ *    processes that attach to it are readers and map it read-only.
+ *    A writer that restarts attaches again as the writer, the table
+ *    is as the last insertion left it.
+ *    A new record is written into an empty slot and published by
+ *    its status, and only then linked into its chain, so a reader
+ *    walking a chain always sees whole records.  Records are never
+ *    moved nor removed.
+ *
+ * => The Object must be trivially copyable, and its hash must be the
+ *    same in every process.  On platforms without POSIX shared memory
+ *    the constructors throw SharedMemoryException.
+*/
+
+template < class Object >
+class shared_coalesced_hashing {
+
+	public:
+
+		/*--- Creates the segment with the given name, the whole table is the address region. ---*/
+		shared_coalesced_hashing( const char * name, size_t size, bool eisch );
+
+		/*--- Creates the segment with the given name, the rest of the address region is the cellar. ---*/
+		shared_coalesced_hashing( const char * name, size_t size, bool eich, const double & addressFactor );
+
+		/* Attaches to an existing segment, as a reader by default.  A
+		 * writer that restarted takes its table back with writable set,
+		 * once the previous writer process is gone.
+		*/
+		explicit shared_coalesced_hashing( const char * name, bool writable = false );
+
+		/*--- Unmaps the segment, which lives on until it is removed. ---*/
+		~shared_coalesced_hashing( );
+
+		/*--- Removes the segment with the given name, mapped tables remain usable. ---*/
+		static bool remove( const char * name );
+
+		/*--- Insert into the table. ---*/
+		void insert( const Object & object );
+
+		/* Insert into the table without throwing.  Readers
+		 * are read-only and get FROZEN.
+		*/
+		InsertResult try_insert( const Object & object );
+
+		/*--- Find an item from the table. ---*/
+		const_ref< Object > find( const Object & object ) const;
+
+		/*--- Returns true if the item is stored in the table. ---*/
+		bool contains( const Object & object ) const;
+
+		/* Find an item from the table without throwing.
+		 * Returns NULL when the item is not stored.
+		*/
+		const Object * try_find( const Object & object ) const;
+
+		/*--- Returns true if this process is the writer of the table. ---*/
+		bool isWriter( ) const;
+
+		/*--- Returns the number of items currently within the table. ---*/
+		size_t elements( ) const;
+
+		/*--- Returns the size of the table. ---*/
+		size_t size( ) const;
+
+		/*--- Returns the number of bytes of the segment. ---*/
+		size_t memory( ) const;
+
+	private: /*--- Private Functions. ---*/
+
+		/*--- Creates and maps the segment. ---*/
+		void create( const char * name, size_t size, bool eisch, double addressFactor, size_t addressSize );
+
+		/*--- Returns the position for the given object. ---*/
+		size_t findPos( const Object & obj ) const;
+
+		/* Searches the given object starting at the given
+		 * position till the end of probe chain.
+		*/
+		SearchedResult findInProbeChain( const Object & obj, size_t pos ) const;
+
+		/*--- No copies, the mapping belongs to one table. ---*/
+		shared_coalesced_hashing( const shared_coalesced_hashing & );
+		shared_coalesced_hashing & operator=( const shared_coalesced_hashing & );
+
+	private: /*--- Private attributes. ---*/
+
+		/*--- An all-zero slot is empty, so a new segment needs no clearing. ---*/
+		enum EntryStatus { EMPTY = 0, ACTIVE = 1 };
+
+		/*--- To store the Coalesced Hashing Entry. ---*/
+		struct SharedEntry {
+
+			/*--- Stores the entry. ---*/
+			Object object;
+
+			/*--- Link position within chain plus one, zero ends the chain. ---*/
+			std::atomic< uint64_t > next;
+
+			/*--- Stores the entry status, set once the object is written. ---*/
+			std::atomic< uint32_t > status;
+		};
+
+		/* Header at the start of the segment.  Every field is 64 bits wide,
+		 * so 32 and 64-bit processes read the same layout.
+		*/
+		struct SharedHeader {
+
+			/*--- Identifies a complete segment, it is written last. ---*/
+			std::atomic< uint64_t > magic;
+
+			/*--- Size of an object, checked when attaching. ---*/
+			uint64_t objectSize;
+
+			/*--- Number of slots and of home addresses. ---*/
+			uint64_t size;
+			uint64_t addressSize;
+
+			/*--- Address factor, -1.0 without a cellar. ---*/
+			double addressFactor;
+
+			/*--- Early or late insertion. ---*/
+			uint64_t eisch;
+
+			/*--- Number of occupied slots. ---*/
+			std::atomic< int64_t > occupied;
+
+			/*--- Bottommost slot that may be empty. ---*/
+			std::atomic< uint64_t > unoccupiedPos;
+		};
+
+		/*--- Atomics that take a lock would keep it in one process only. ---*/
+		static_assert( std::atomic< uint64_t >::is_always_lock_free && std::atomic< uint32_t >::is_always_lock_free,
+			"The atomics of the segment must be lock free to be shared between processes." );
+
+		/*--- Mapping of the segment. ---*/
+		void * segment;
+		size_t segmentSize;
+
+		/*--- Header and slots within the segment. ---*/
+		SharedHeader * header;
+		SharedEntry * array;
+
+		/*--- True for the process that created the segment. ---*/
+		bool writer;
+};
+#endif
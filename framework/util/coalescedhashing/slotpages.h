@@ -0,0 +1,237 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __SLOT_PAGES_H__
+#define __SLOT_PAGES_H__
+
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+using std::vector;
+
+/**
+ * Array of slots stored in pages of about 4KB that can be shared with
+ * read-only views of the array.  A view shares the table of pages and the
+ * pages, and the first write to a page that is still shared copies that page
+ * only, so a view keeps the slots as they were when it was taken.
+ *
+ * => Slots are read with operator[ ] and written through write( ).
+ *    An array that never gave a view writes its slots in place, with no
+ *    check of the pages, and a plain copy of it copies the slots.
+ *
+ * => share( ) returns a view, which shares the table of pages rather than
+ *    copying it.  The first write that follows copies the table of pages,
+ *    one pointer per page, and every write until the last view is released
+ *    checks whether its page is still shared.
+ *
+ * => A view may be read and released by another thread while the array is
+ *    written, as long as only one thread writes the array and takes views.
+*/
+
+/*--- Bytes of a page of slots. ---*/
+#define SLOT_PAGE_BYTES 4096
+
+/*--- Returns the shift of the largest power of two of slots within the given bytes, at least one slot. ---*/
+constexpr size_t slotPageShift( size_t bytes, size_t slotBytes ) {
+
+	return ( bytes / slotBytes >= 2 ) ? 1 + slotPageShift( bytes / 2, slotBytes ) : 0;
+}
+
+template < class Entry >
+class slot_pages {
+
+	public:
+
+		/*--- Constructor, every slot is default constructed. ---*/
+		slot_pages( size_t slots = 0 ) : table( std::make_shared< PageTable >( ) ), slots( slots ), shared( false ), view( false ) {
+
+			table->pages.resize( ( slots + PAGE_SLOTS - 1 ) / PAGE_SLOTS );
+			table->bases.resize( table->pages.size( ) );
+			for( size_t i = 0; i < table->pages.size( ); i++ ) {
+
+				table->pages[ i ] = std::make_shared< Page >( );
+				table->bases[ i ] = table->pages[ i ]->entries;
+			}
+
+			bases = table->bases.data( );
+		}
+
+		/*--- Copy constructor, copies the slots, or shares them again when copying a view. ---*/
+		slot_pages( const slot_pages & other ) : slots( other.slots ), shared( false ), view( other.view ) {
+
+			if( view ) {
+
+				sharers = other.sharers;
+				table = other.table;
+			}
+
+			else {
+
+				table = std::make_shared< PageTable >( );
+				table->pages.resize( other.table->pages.size( ) );
+				table->bases.resize( table->pages.size( ) );
+				for( size_t i = 0; i < table->pages.size( ); i++ ) {
+
+					table->pages[ i ] = std::make_shared< Page >( *other.table->pages[ i ] );
+					table->bases[ i ] = table->pages[ i ]->entries;
+				}
+			}
+
+			bases = table->bases.data( );
+		}
+
+		slot_pages( slot_pages && other ) = default;
+
+		/*--- Assignment, as the copy constructor. ---*/
+		slot_pages & operator=( slot_pages other ) {
+
+			swap( other );
+			return *this;
+		}
+
+		/* Returns a read-only view sharing the pages of the array.  From then
+		 * on the array copies a page the first time it writes it.
+		*/
+		slot_pages share( ) const {
+
+			if( !sharers )
+				sharers = std::make_shared< char >( );
+
+			shared = true;
+			return slot_pages( *this, table );
+		}
+
+		/*--- Returns the slot at the given position for reading. ---*/
+		const Entry & operator[ ]( size_t pos ) const {
+
+			return bases[ pos >> PAGE_SHIFT ][ pos & ( PAGE_SLOTS - 1 ) ];
+		}
+
+		/*--- Returns the slot at the given position for writing, copying its page if shared. ---*/
+		Entry & write( size_t pos ) {
+
+			size_t index = pos >> PAGE_SHIFT;
+			if( shared )
+				unshare( index );
+
+			return bases[ index ][ pos & ( PAGE_SLOTS - 1 ) ];
+		}
+
+		/*--- Returns the number of slots. ---*/
+		size_t size( ) const { return slots; }
+
+		/*--- Returns the number of bytes of the pages. ---*/
+		size_t memory( ) const {
+
+			return table->pages.size( ) * sizeof( Page ) + table->pages.capacity( ) * sizeof( std::shared_ptr< Page > ) +
+				table->bases.capacity( ) * sizeof( Entry * );
+		}
+
+		/*--- Exchanges the slots with the given array. ---*/
+		void swap( slot_pages & other ) {
+
+			sharers.swap( other.sharers );
+			table.swap( other.table );
+			std::swap( bases, other.bases );
+			std::swap( slots, other.slots );
+			std::swap( shared, other.shared );
+			std::swap( view, other.view );
+		}
+
+	private:
+
+		static const size_t PAGE_SHIFT = slotPageShift( SLOT_PAGE_BYTES, sizeof( Entry ) );
+		static const size_t PAGE_SLOTS = ( size_t )1 << PAGE_SHIFT;
+
+		struct Page {
+
+			Entry entries[ PAGE_SLOTS ];
+		};
+
+		/*--- Pages of the array, and the first slot of every page so that a read follows a single pointer. ---*/
+		struct PageTable {
+
+			vector< std::shared_ptr< Page > > pages;
+			vector< Entry * > bases;
+		};
+
+		/*--- Constructor of a view of the given array. ---*/
+		slot_pages( const slot_pages & array, const std::shared_ptr< PageTable > & pages )
+			: sharers( array.sharers ), table( pages ), bases( pages->bases.data( ) ), slots( array.slots ),
+				shared( false ), view( true ) {
+
+		}
+
+		/*--- Copies the table of pages and the given page while a view still holds them. ---*/
+		void unshare( size_t index ) {
+
+			/*--- Every view was released, orders the writes after their reads. ---*/
+			if( sharers.use_count( ) == 1 ) {
+
+				std::atomic_thread_fence( std::memory_order_acquire );
+				sharers.reset( );
+				shared = false;
+				return;
+			}
+
+			if( table.use_count( ) > 1 ) {
+
+				table = std::make_shared< PageTable >( *table );
+				bases = table->bases.data( );
+			}
+
+			if( table->pages[ index ].use_count( ) > 1 ) {
+
+				table->pages[ index ] = std::make_shared< Page >( *table->pages[ index ] );
+				bases[ index ] = table->pages[ index ]->entries;
+			}
+
+			/*--- Orders the write after the reads of the view that released the page. ---*/
+			else
+				std::atomic_thread_fence( std::memory_order_acquire );
+		}
+
+		/*--- Held by the array and its views while there are views, released last. ---*/
+		mutable std::shared_ptr< char > sharers;
+
+		/*--- Table of pages, shared with the views until written. ---*/
+		std::shared_ptr< PageTable > table;
+
+		/*--- First slot of every page, from the table of pages. ---*/
+		Entry ** bases;
+
+		/*--- Number of slots. ---*/
+		size_t slots;
+
+		/*--- True while views may hold the pages of the array. ---*/
+		mutable bool shared;
+
+		/*--- True for a view, whose copies share its pages. ---*/
+		bool view;
+};
+
+#endif
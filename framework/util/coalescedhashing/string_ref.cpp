@@ -0,0 +1,71 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#include "string_ref.h"
+#include "exceptions.h"
+
+/**
+ * Class that wraps a string key found within a
+ * coalesced_string_hashing table.
+*/
+
+/*--- Default Constructor. ---*/
+string_ref::string_ref( )
+	: found( false ), probes( 0 ), linkpos( 0 ) {
+}
+
+/*--- Constructor that takes in a view of the stored key. ---*/
+string_ref::string_ref( string_view key, size_t linkpos, size_t probes )
+	: key( key ), found( true ), probes( probes ), linkpos( linkpos ) {
+}
+
+/*--- Returns the key. ---*/
+string_view string_ref::getObject( ) const {
+
+	/*--- Check if the key was found. ---*/
+	if( !isNULL( ) )
+		return key;
+
+	/*--- Throw a NullPointerException. ---*/
+	throw NullPointerException( );
+}
+
+/*--- Returns the number of probes. ---*/
+size_t string_ref::getProbes( ) const {
+
+	return probes;
+}
+
+/*--- Returns the link position. ---*/
+size_t string_ref::getLinkPos( ) const {
+
+	return linkpos;
+}
+
+/*--- Returns true if the key was not found. ---*/
+bool string_ref::isNULL( ) const {
+
+	return !found;
+}
@@ -0,0 +1,77 @@
+/*
+* The MIT License(MIT)
+*
+* Copyright(c) 2019 - 2020 Sergio A. Hernandez, Jr.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files(the "Software"), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and /or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions :
+*
+* The above copyright noticeand this permission notice shall be included in all copies or substantial
+* portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+* LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name(s) of the above copyright holders shall not be used in
+* advertising or otherwise to promote the sale, use or other dealings in this Software without prior
+* written authorization.
+*/
+
+#ifndef __STRING_REF__
+#define __STRING_REF__
+
+#include <stddef.h>
+#include <string_view>
+using std::string_view;
+
+/**
+ * Class that wraps a string key found within a
+ * coalesced_string_hashing table.  The key bytes live either
+ * inside the slot or inside the table arena, so the view is only
+ * valid until the next insertion into, removal from, or clearing
+ * of the table.
+*/
+
+class string_ref {
+
+	public:
+
+		/*--- Default Constructor. ---*/
+		string_ref( );
+
+		/*--- Constructor that takes in a view of the stored key. ---*/
+		string_ref( string_view key, size_t linkpos, size_t probes );
+
+		/*--- Returns the key. ---*/
+		string_view getObject( ) const;
+
+		/*--- Returns the number of probes. ---*/
+		size_t getProbes( ) const;
+
+		/*--- Returns the link position. ---*/
+		size_t getLinkPos( ) const;
+
+		/*--- Returns true if the key was not found. ---*/
+		bool isNULL( ) const;
+
+	private:
+
+		/*--- View of the stored key. ---*/
+		string_view key;
+
+		/*--- Flag set when the key was found. ---*/
+		bool found;
+
+		/*--- Stores the number probes. ---*/
+		size_t probes;
+
+		/*--- Stores the link position. ---*/
+		size_t linkpos;
+};
+#endif